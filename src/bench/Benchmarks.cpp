@@ -0,0 +1,704 @@
+#include "Benchmarks.h"
+#include "../world/SoilKernel.h"
+#include "../world/TileMap.h"
+#include "../world/HierarchicalPathfinder.h"
+#include "../world/RailNetwork.h"
+#include "../world/RailRouter.h"
+#include "../world/SpatialHash.h"
+#include "../systems/RailTraffic.h"
+#include "../systems/CropField.h"
+#include "../systems/Logistics.h"
+#include "../systems/FastForward.h"
+#include "../entities/Crop.h"
+#include "../entities/Cart.h"
+#include "../entities/Entity.h"
+#include "../resources/ResourceManager.h"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+// seconds per call of fn, averaged over iters after one warm-up call
+static double timeIt(int iters, const std::function<void()>& fn) {
+    fn();
+    auto t0 = BenchClock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    return std::chrono::duration<double>(BenchClock::now() - t0).count() / iters;
+}
+
+// soil: one updateSoil step over a 2048x2048 map, pre-kernel branchy loop vs each SIMD variant
+static nlohmann::json benchSoil() {
+    const size_t side = 2048, n = side * side;
+    const int iters = 50;
+    std::vector<float> m(n), f(n);
+    auto reset = [&]{ for (size_t i = 0; i < n; ++i) { m[i] = float(i % 97) / 96.f; f[i] = float(i % 89) / 88.f; } };
+    SoilStep s; s.moistureTarget = 0.3f; s.moistureDown = 0.02f/60.f; s.moistureUp = 0.01f/60.f; s.fertilityTarget = 0.5f; s.fertilityUp = 0.005f/60.f;
+
+    nlohmann::json out; out["bench"] = "soil"; out["tiles"] = n; out["iters"] = iters; out["selected"] = soilKernelName();
+    reset();
+    double base = timeIt(iters, [&]{
+        // the original per-tile loop from TileMap::updateSoil
+        for (size_t i = 0; i < n; ++i) {
+            float &v = m[i];
+            if (v > s.moistureTarget) v = std::max(s.moistureTarget, v - s.moistureDown);
+            else if (v < s.moistureTarget) v = std::min(s.moistureTarget, v + s.moistureUp);
+        }
+        for (size_t i = 0; i < n; ++i) if (f[i] < s.fertilityTarget) f[i] = std::min(s.fertilityTarget, f[i] + s.fertilityUp);
+    });
+    out["results"]["branchy_baseline"] = { {"tiles_per_sec", n / base}, {"ms_per_step", base * 1e3} };
+    SoilKernelVariant variants[3];
+    size_t count = soilKernelVariants(variants, 3);
+    for (size_t v = 0; v < count; ++v) {
+        reset();
+        double t = timeIt(iters, [&]{ variants[v].fn(m.data(), f.data(), n, s); });
+        out["results"][variants[v].name] = { {"tiles_per_sec", n / t}, {"ms_per_step", t * 1e3}, {"speedup", base / t} };
+    }
+    return out;
+}
+
+// collision: the row-mask queries (isSpanSolid / isTileRectSolid / isRectColliding / sweepAxis) against
+// per-tile loops over getTile on a 1000x700 map (partial edge chunks) with ~10% walls. Query ends are
+// biased onto chunk boundaries and past the map edge; every answer is compared, mismatches must be 0.
+static nlohmann::json benchCollision() {
+    const unsigned mw = 1000, mh = 700, ts = 32, C = TileMap::ChunkTiles;
+    TileMap map(mw, mh, ts);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<unsigned> tx(0, mw - 1), ty(0, mh - 1), coin(0, 3), len(0, 80);
+    for (unsigned i = 0; i < mw * mh / 10; ++i) map.setTile(tx(rng), ty(rng), TileMap::Solid);
+    for (unsigned i = 0; i < 40; ++i) { unsigned y = ty(rng), x = tx(rng); for (unsigned k = 0; k < 3 * C; ++k) if (x + k < mw) map.setTile(x + k, y, TileMap::Solid); }
+    auto solid = [&](int x, int y){ return x >= 0 && y >= 0 && x < int(mw) && y < int(mh) && map.getTile(x, y) == TileMap::Solid; };
+    // a column near a chunk edge (or the map edge) a quarter of the time
+    auto col = [&]{ unsigned x = tx(rng); if (coin(rng) == 0) { x = (x / C) * C + (coin(rng) % 3) - 1; } return std::min(x, mw + 40); };
+    const int count = 200000;
+    nlohmann::json out; out["bench"] = "collision"; out["map"] = {mw, mh}; out["queries"] = count;
+    unsigned bad = 0;
+    // spans and rects: masks vs per-tile scan (rows past the map are clipped, like the masks)
+    struct Rect { unsigned x0, y0, x1, y1; };
+    std::vector<Rect> rects(count);
+    for (auto &r : rects) { r.x0 = col(); r.x1 = r.x0 + (coin(rng) ? len(rng) % 8 : len(rng)); r.y0 = ty(rng); r.y1 = r.y0 + coin(rng) / 2; } // mostly small, some long runs
+    auto perTile = [&](const Rect& r){ for (unsigned y = r.y0; y <= r.y1; ++y) for (unsigned x = r.x0; x <= r.x1; ++x) if (solid(int(x), int(y))) return true; return false; };
+    int hits = 0;
+    double tMask = timeIt(3, [&]{ hits = 0; for (auto &r : rects) hits += map.isTileRectSolid(r.x0, r.y0, r.x1, r.y1); });
+    int tileHits = 0;
+    double tTile = timeIt(3, [&]{ tileHits = 0; for (auto &r : rects) tileHits += perTile(r); });
+    bad += unsigned(std::abs(hits - tileHits));
+    for (auto &r : rects) {
+        bad += map.isTileRectSolid(r.x0, r.y0, r.x1, r.y1) != perTile(r);
+        bad += map.isSpanSolid(r.y0, r.x0, r.x1) != perTile({r.x0, r.y0, r.x1, r.y0});
+    }
+    out["rects"] = { {"mask_per_sec", count / tMask}, {"per_tile_per_sec", count / tTile}, {"hit_ratio", double(hits) / count} };
+    // pixel rects, including ones poking out of the world (always colliding)
+    std::uniform_real_distribution<float> px(-40.f, float(mw * ts) + 40.f), py(-40.f, float(mh * ts) + 40.f), ext(1.f, 120.f);
+    for (int i = 0; i < count; ++i) {
+        sf::FloatRect b({px(rng), py(rng)}, {ext(rng), ext(rng)});
+        bool ref = b.position.x < 0.f || b.position.y < 0.f || b.position.x + b.size.x > float(mw * ts) || b.position.y + b.size.y > float(mh * ts);
+        if (!ref) {
+            int x0 = int(b.position.x / ts), y0 = int(b.position.y / ts);
+            int x1 = int((b.position.x + b.size.x - 0.0001f) / ts), y1 = int((b.position.y + b.size.y - 0.0001f) / ts);
+            for (int y = y0; y <= y1 && !ref; ++y) for (int x = x0; x <= x1 && !ref; ++x) ref = solid(x, y);
+        }
+        bad += map.isRectColliding(b) != ref;
+    }
+    // sweeps: clamp a box along one axis, reference steps the leading edge one tile line at a time
+    std::uniform_real_distribution<float> mv(-300.f, 300.f);
+    double tSweep = 0.0; int clamped = 0;
+    for (int i = 0; i < count; ++i) {
+        sf::FloatRect b({px(rng), py(rng)}, {ext(rng) / 4.f, ext(rng) / 4.f});
+        float move = mv(rng); bool horiz = i % 2;
+        auto t0 = BenchClock::now(); float got = map.sweepAxis(b, move, horiz); tSweep += std::chrono::duration<double>(BenchClock::now() - t0).count();
+        float lo = horiz ? b.position.x : b.position.y, hi = lo + (horiz ? b.size.x : b.size.y);
+        float pLo = horiz ? b.position.y : b.position.x, pHi = pLo + (horiz ? b.size.y : b.size.x);
+        int p0 = int(std::floor(pLo / ts)), p1 = int(std::floor((pHi - 0.0001f) / ts));
+        float ref = move;
+        if (move > 0.f) {
+            for (int a = int(std::ceil(hi / ts)); a <= int(std::ceil((hi + move) / ts)) - 1 && ref == move; ++a)
+                for (int p = p0; p <= p1; ++p) if (horiz ? solid(a, p) : solid(p, a)) { ref = a * float(ts) - hi; break; }
+        } else if (move < 0.f) {
+            for (int a = int(std::floor(lo / ts)) - 1; a >= int(std::floor((lo + move) / ts)) && ref == move; --a)
+                for (int p = p0; p <= p1; ++p) if (horiz ? solid(a, p) : solid(p, a)) { ref = (a + 1) * float(ts) - lo; break; }
+        }
+        clamped += ref != move;
+        bad += got != ref;
+    }
+    out["sweeps"] = { {"per_sec", count / std::max(1e-12, tSweep)}, {"clamped_ratio", double(clamped) / count} };
+    out["mismatches"] = bad;
+    return out;
+}
+
+// rays: DDA raycasts and swept circles over a 2048x2048 map with ~10% scattered walls
+static nlohmann::json benchRays() {
+    const unsigned side = 2048, ts = 32;
+    TileMap map(side, side, ts);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> tile(0, side - 1);
+    for (unsigned i = 0; i < side * side / 10; ++i) map.setTile(tile(rng), tile(rng), TileMap::Solid);
+    const int count = 200000;
+    std::uniform_real_distribution<float> pos(0.f, float(side * ts)), off(-1.f, 1.f);
+    auto segments = [&](float reach){
+        std::vector<std::pair<sf::Vector2f, sf::Vector2f>> v(count);
+        for (auto &s : v) { s.first = {pos(rng), pos(rng)}; s.second = s.first + sf::Vector2f{off(rng), off(rng)} * reach; }
+        return v;
+    };
+    nlohmann::json out; out["bench"] = "rays"; out["map"] = side; out["rays"] = count;
+    auto run = [&](const char* name, float reachTiles, auto query){
+        auto segs = segments(reachTiles * ts);
+        int hits = 0;
+        double t = timeIt(3, [&]{ hits = 0; for (auto &s : segs) hits += query(s.first, s.second) ? 1 : 0; });
+        out["results"][name] = { {"rays_per_sec", count / t}, {"reach_tiles", reachTiles}, {"hit_ratio", double(hits) / count} };
+    };
+    run("raycast_los", 64.f, [&](sf::Vector2f a, sf::Vector2f b){ return map.raycast(a, b).hit; });
+    run("raycast_short", 8.f, [&](sf::Vector2f a, sf::Vector2f b){ return map.raycast(a, b).hit; });
+    run("sweep_circle_r4", 8.f, [&](sf::Vector2f a, sf::Vector2f b){ return map.sweepCircle(a, b, 4.f).hit; });
+    // brute force: raycast vs a slab test against every blocking tile in the segment's bounds; sweepCircle
+    // vs marching the circle along the segment in 1/8 px steps. A mismatch is a different hit flag, or a
+    // hit further apart along the segment than the reference can resolve.
+    const float h = 0.125f, r = 4.f;
+    const int checks = 20000;
+    auto solidAt = [&](int x, int y){ return x >= 0 && y >= 0 && x < int(side) && y < int(side) && map.getTile(x, y) == TileMap::Solid; };
+    auto march = [&](sf::Vector2f a, sf::Vector2f b, auto blocked){
+        sf::Vector2f d = b - a; float len = std::sqrt(d.x*d.x + d.y*d.y); int n = std::max(1, int(std::ceil(len / h)));
+        for (int k = 0; k <= n; ++k) if (blocked(a + d * (float(k) / n))) return float(k) / n;
+        return 2.f; // clear
+    };
+    auto slabs = [&](sf::Vector2f a, sf::Vector2f b){
+        float best = 2.f, t;
+        for (int y = int(std::floor(std::min(a.y, b.y) / ts)); y <= int(std::floor(std::max(a.y, b.y) / ts)); ++y)
+            for (int x = int(std::floor(std::min(a.x, b.x) / ts)); x <= int(std::floor(std::max(a.x, b.x) / ts)); ++x) {
+                bool blocks = x < 0 || y < 0 || x >= int(side) || y >= int(side) || solidAt(x, y); // leaving the map is a hit
+                if (blocks && segmentIntersectsRect(a, b, sf::FloatRect({float(x) * ts, float(y) * ts}, {float(ts), float(ts)}), &t)) best = std::min(best, t);
+            }
+        return best;
+    };
+    auto mismatch = [&](const TileMap::RayHit& got, float ref, float tol){
+        if (got.hit != (ref <= 1.f)) return 1u;
+        return got.hit && std::abs(got.t - ref) > tol ? 1u : 0u;
+    };
+    unsigned rayBad = 0, sweepBad = 0;
+    for (int i = 0; i < checks; ++i) {
+        sf::Vector2f a{pos(rng), pos(rng)}, b = a + sf::Vector2f{off(rng), off(rng)} * (8.f * ts);
+        float len = std::max(h, std::hypot(b.x - a.x, b.y - a.y));
+        rayBad += mismatch(map.raycast(a, b), slabs(a, b), 1e-3f);
+        sweepBad += mismatch(map.sweepCircle(a, b, r), march(a, b, [&](sf::Vector2f p){
+            for (int y = int(std::floor((p.y - r) / ts)); y <= int(std::floor((p.y + r) / ts)); ++y)
+                for (int x = int(std::floor((p.x - r) / ts)); x <= int(std::floor((p.x + r) / ts)); ++x) {
+                    if (!solidAt(x, y)) continue;
+                    float cx = std::clamp(p.x, float(x) * ts, float(x + 1) * ts), cy = std::clamp(p.y, float(y) * ts, float(y + 1) * ts);
+                    if ((p.x - cx) * (p.x - cx) + (p.y - cy) * (p.y - cy) <= r * r) return true;
+                }
+            return false; }), 2.f * h / len);
+    }
+    out["brute_force"] = { {"segments", checks}, {"step_px", h}, {"raycast_mismatches", rayBad}, {"sweep_circle_mismatches", sweepBad} };
+    return out;
+}
+
+// paths: HPA* point-to-point queries on a 2048x2048 map laid out like a base: wall segments with
+// door gaps, rock clumps and 2% scattered rubble. Pass "paths_noise" for 10% uniform noise instead,
+// the worst case for HPA* (many short border runs, so many portals).
+static nlohmann::json benchPaths(bool noise) {
+    const unsigned side = 2048;
+    TileMap map(side, side, 32);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<unsigned> tile(0, side - 1);
+    std::uniform_int_distribution<unsigned> len(8, 160);
+    if (noise) {
+        for (unsigned i = 0; i < side * side / 10; ++i) map.setTile(tile(rng), tile(rng), TileMap::Solid);
+    } else {
+        for (int i = 0; i < 6000; ++i) {
+            unsigned x = tile(rng), y = tile(rng), n = len(rng); bool horiz = i % 2;
+            for (unsigned k = 0; k < n; ++k) {
+                if (k % 24 >= 20) continue; // doorway every 24 tiles
+                unsigned tx = horiz ? x + k : x, ty = horiz ? y : y + k;
+                if (tx < side && ty < side) map.setTile(tx, ty, TileMap::Solid);
+            }
+        }
+        for (int i = 0; i < 3000; ++i) { unsigned x = tile(rng), y = tile(rng); for (unsigned k = 0; k < 16; ++k) map.setTile(std::min(side - 1, x + k % 4), std::min(side - 1, y + k / 4), TileMap::Solid); }
+        for (unsigned i = 0; i < side * side / 50; ++i) map.setTile(tile(rng), tile(rng), TileMap::Solid);
+    }
+    HierarchicalPathfinder hpa(map);
+    nlohmann::json out; out["bench"] = noise ? "paths_noise" : "paths"; out["map"] = side;
+    auto ms = [](BenchClock::time_point a){ return std::chrono::duration<double, std::milli>(BenchClock::now() - a).count(); };
+    auto t0 = BenchClock::now(); hpa.sync(); out["build_ms"] = ms(t0); out["abstract_nodes"] = hpa.nodeCount();
+    auto queries = [&](int count){
+        std::vector<double> lat; int found = 0;
+        while (int(lat.size()) < count) {
+            sf::Vector2i a(int(tile(rng)), int(tile(rng))), b(int(tile(rng)), int(tile(rng)));
+            if (map.isTileSolid(a.x, a.y) || map.isTileSolid(b.x, b.y)) continue;
+            auto q = BenchClock::now(); found += hpa.findPath(a, b).empty() ? 0 : 1; lat.push_back(ms(q));
+        }
+        std::sort(lat.begin(), lat.end());
+        return nlohmann::json{ {"queries", count}, {"found", found}, {"p50_ms", lat[lat.size() / 2]}, {"p99_ms", lat[lat.size() * 99 / 100]}, {"max_ms", lat.back()} };
+    };
+    out["query"] = queries(1000);
+    // incremental repair: scattered solid flips, then the sync the next query pays for
+    for (int i = 0; i < 100; ++i) map.setTile(tile(rng), tile(rng), (i % 2) ? TileMap::Solid : TileMap::Empty);
+    unsigned before = hpa.clusterRepairs();
+    t0 = BenchClock::now(); hpa.sync();
+    out["repair"] = { {"tile_flips", 100}, {"clusters_repaired", hpa.clusterRepairs() - before}, {"ms", ms(t0)} };
+    return out;
+}
+
+// rail_components: 200k random rail add/remove ops on a 32x32 grid held near half full (many splits and
+// merges; removals leave enough tombstones to trigger compaction), with RailNetwork's components checked
+// after every op against a flood fill: same partition, sizes and count. mismatches must be 0.
+static nlohmann::json benchRailComponents() {
+    const unsigned side = 32, n = side * side, ops = 200000;
+    RailNetwork net; net.reset(side);
+    std::vector<uint8_t> rail(n, 0);
+    std::vector<int> label(n), queue; queue.reserve(n);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<unsigned> tile(0, n - 1);
+    std::vector<int> labelToComp;
+    std::vector<size_t> labelSize;
+    unsigned bad = 0, adds = 0, removes = 0, maxComponents = 0;
+    double opSec = 0.0;
+    while (adds + removes < ops) {
+        unsigned t = tile(rng);
+        bool add = rail[t] ? (rng() % 100 < 45) : (rng() % 100 < 55); // drift back toward half full
+        if (add == bool(rail[t])) continue;
+        auto t0 = BenchClock::now();
+        if (add) net.add(t % side, t / side); else net.remove(t % side, t / side);
+        opSec += std::chrono::duration<double>(BenchClock::now() - t0).count();
+        rail[t] = add; (add ? adds : removes)++;
+        // flood fill every component from scratch
+        std::fill(label.begin(), label.end(), -1); labelSize.clear();
+        for (unsigned s0 = 0; s0 < n; ++s0) {
+            if (!rail[s0] || label[s0] >= 0) continue;
+            int id = int(labelSize.size()); labelSize.push_back(0);
+            queue.assign(1, int(s0)); label[s0] = id;
+            for (size_t q = 0; q < queue.size(); ++q) {
+                int k = queue[q], x = k % int(side); ++labelSize[id];
+                int nb[4] = {k >= int(side) ? k - int(side) : -1, x + 1 < int(side) ? k + 1 : -1, k + int(side) < int(n) ? k + int(side) : -1, x > 0 ? k - 1 : -1};
+                for (int m : nb) if (m >= 0 && rail[m] && label[m] < 0) { label[m] = id; queue.push_back(m); }
+            }
+        }
+        bad += net.componentCount() != labelSize.size();
+        bad += net.tileCount() != size_t(std::count(rail.begin(), rail.end(), 1));
+        // partitions match when every flood-fill piece sits in one component and no two pieces share one
+        labelToComp.assign(labelSize.size(), -1);
+        for (unsigned k = 0; k < n; ++k) {
+            if (bool(rail[k]) != net.contains(k % side, k / side)) { ++bad; continue; }
+            if (!rail[k]) continue;
+            int c = net.component(k % side, k / side), &seen = labelToComp[label[k]];
+            if (seen >= 0) { bad += seen != c; continue; }
+            seen = c;
+            bad += net.componentSize(k % side, k / side) != labelSize[label[k]];
+        }
+        std::sort(labelToComp.begin(), labelToComp.end());
+        bad += unsigned(std::adjacent_find(labelToComp.begin(), labelToComp.end()) != labelToComp.end());
+        maxComponents = std::max(maxComponents, net.componentCount());
+    }
+    nlohmann::json out; out["bench"] = "rail_components"; out["grid"] = side;
+    out["adds"] = adds; out["removes"] = removes; out["max_components"] = maxComponents;
+    out["us_per_op"] = opSec * 1e6 / std::max(1u, adds + removes);
+    out["mismatches"] = bad;
+    return out;
+}
+
+// rail_routes: RailRouter on an 80x60 random rail maze against BFS over the railBits links. 3000 queries
+// in rounds of 100, half of them repeats (cache hits), with a few rail tiles flipped between rounds so
+// cached routes must be dropped when the network version moves. A route must start and end at the query
+// tiles, follow linked rail and be exactly as long as the BFS distance; unreachable pairs must be empty.
+// Carts with stops in the maze replan after every edit (one of them cuts a rail under a route): their
+// waypoints must stay adjacent rail tiles, or be empty when no rail leads the cart back to its route.
+static nlohmann::json benchRailRoutes() {
+    const unsigned mw = 80, mh = 60, rounds = 30, perRound = 100;
+    TileMap map(mw, mh, 32);
+    std::mt19937 rng(12);
+    std::uniform_int_distribution<unsigned> tx(0, mw - 1), ty(0, mh - 1);
+    for (unsigned y = 0; y < mh; ++y) for (unsigned x = 0; x < mw; ++x) if (rng() % 100 < 62) map.setTile(x, y, TileMap::Rail);
+    RailRouter router(map);
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0}; // railBits order: N, E, S, W
+    std::vector<int> dist(mw * mh); std::vector<unsigned> queue;
+    auto bfs = [&](sf::Vector2u from, sf::Vector2u to){
+        std::fill(dist.begin(), dist.end(), -1);
+        queue.assign(1, from.x + from.y * mw); dist[queue[0]] = 0;
+        for (size_t q = 0; q < queue.size(); ++q) {
+            unsigned k = queue[q]; uint8_t bits = map.railBits(k % mw, k / mw);
+            for (int d = 0; d < 4; ++d) {
+                if (!(bits & (1u << d))) continue;
+                unsigned n = unsigned(int(k % mw) + dx[d]) + unsigned(int(k / mw) + dy[d]) * mw;
+                if (dist[n] < 0) { dist[n] = dist[k] + 1; queue.push_back(n); }
+            }
+        }
+        return dist[to.x + to.y * mw];
+    };
+    auto linked = [&](sf::Vector2u a, sf::Vector2u b){
+        for (int d = 0; d < 4; ++d) if ((map.railBits(a.x, a.y) & (1u << d)) && int(a.x) + dx[d] == int(b.x) && int(a.y) + dy[d] == int(b.y)) return true;
+        return false;
+    };
+    auto railTile = [&]{ sf::Vector2u t; do t = {tx(rng), ty(rng)}; while (!map.isTileRail(t.x, t.y)); return t; };
+    // carts looping (or running once) through the maze; every round cuts a rail under one route, and the
+    // replanned waypoints must stay a chain of adjacent rail tiles with the cart at most a tile from the next
+    std::streambuf* quiet = std::cerr.rdbuf(nullptr); // carts and textures log per call
+    ResourceManager res;
+    std::vector<std::unique_ptr<Cart>> carts;
+    for (unsigned i = 0; i < 24; ++i) {
+        auto c = std::make_unique<Cart>(res, sf::Vector2f(), map.tileSize());
+        c->setTileMap(&map); c->setRouter(&router); c->setLoop(i % 3 != 0);
+        c->addStop(railTile());
+        for (unsigned tries = 0; tries < 40 && c->getStops().size() < 4; ++tries) c->addStop(railTile()); // other components are rejected
+        carts.push_back(std::move(c));
+    }
+    const sf::Time tick = sf::seconds(1.f / 60.f);
+    auto chainBroken = [&](const Cart& c){
+        sf::Vector2u a, b;
+        if (!c.routeAhead(0, a)) return false; // held where no rail leads back to its route
+        sf::Vector2f d = c.worldPosition() - sf::Vector2f((a.x + 0.5f) * 32.f, (a.y + 0.5f) * 32.f);
+        if (std::hypot(d.x, d.y) > 32.01f) return true;
+        for (size_t k = 0; k < c.getWaypoints().size() && c.routeAhead(k, a); ++k) {
+            if (!map.isTileRail(a.x, a.y)) return true;
+            if (c.getWaypoints().size() > 1 && c.routeAhead(k + 1, b) && std::abs(int(a.x) - int(b.x)) + std::abs(int(a.y) - int(b.y)) != 1) return true;
+        }
+        return false;
+    };
+    unsigned chainBad = 0, cartsHeld = 0;
+    std::vector<std::pair<sf::Vector2u, sf::Vector2u>> asked;
+    unsigned bad = 0, reachable = 0, flips = 0;
+    double routeSec = 0.0;
+    for (unsigned round = 0; round < rounds; ++round) {
+        for (unsigned q = 0; q < perRound; ++q) {
+            auto pr = (q % 2 && !asked.empty()) ? asked[rng() % asked.size()] : std::make_pair(railTile(), railTile());
+            if (!(q % 2)) asked.push_back(pr);
+            auto t0 = BenchClock::now();
+            auto r = router.route(pr.first, pr.second);
+            routeSec += std::chrono::duration<double>(BenchClock::now() - t0).count();
+            int d = bfs(pr.first, pr.second);
+            if (d < 0) { bad += !r->empty(); continue; }
+            ++reachable;
+            if (r->size() != size_t(d) + 1 || r->front() != pr.first || r->back() != pr.second) { ++bad; continue; }
+            for (size_t i = 1; i < r->size(); ++i) if (!map.isTileRail((*r)[i].x, (*r)[i].y) || !linked((*r)[i - 1], (*r)[i])) { ++bad; break; }
+        }
+        for (unsigned t = 0; t < 90; ++t) for (auto &c : carts) c->update(tick);
+        // edit the network: repeats asked next round were cached against the old version
+        uint32_t before = router.version();
+        const auto &cut = carts[round % carts.size()]->getWaypoints();
+        if (!cut.empty()) { sf::Vector2u t = cut[rng() % cut.size()]; map.setTile(t.x, t.y, TileMap::Empty); ++flips; }
+        for (int i = 0; i < 6; ++i, ++flips) { unsigned x = tx(rng), y = ty(rng); map.setTile(x, y, map.isTileRail(x, y) ? TileMap::Empty : TileMap::Rail); }
+        bad += router.version() == before;
+        for (auto &c : carts) { c->update(tick); chainBad += chainBroken(*c); } // replans against the new version
+        asked.erase(std::remove_if(asked.begin(), asked.end(), [&](auto &p){ return !map.isTileRail(p.first.x, p.first.y) || !map.isTileRail(p.second.x, p.second.y); }), asked.end());
+    }
+    for (auto &c : carts) cartsHeld += c->getWaypoints().empty();
+    std::cerr.rdbuf(quiet);
+    nlohmann::json out; out["bench"] = "rail_routes"; out["map"] = {mw, mh};
+    out["queries"] = rounds * perRound; out["reachable"] = reachable; out["rail_flips"] = flips;
+    out["searches"] = router.searches(); out["cache_hits"] = router.cacheHits();
+    out["us_per_query"] = routeSec * 1e6 / (rounds * perRound);
+    out["mismatches"] = bad;
+    out["route_carts"] = carts.size(); out["carts_held_off_route"] = cartsHeld;
+    out["route_chain_mismatches"] = chainBad;
+    return out;
+}
+
+// traffic: 1000 carts circling an 8x8 grid of overlapping one-way rail rings (shared track segments,
+// T junctions and crossings), signaled by RailTraffic for 60 simulated seconds
+static nlohmann::json benchTraffic() {
+    const unsigned rings = 8, side = 24, step = 20, carts = 1000, ticks = 3600;
+    const unsigned extent = 2 + (rings - 1) * step + side + 2;
+    TileMap map(extent, extent, 32);
+    std::vector<std::vector<sf::Vector2u>> loops; // clockwise perimeter per ring
+    for (unsigned ry = 0; ry < rings; ++ry) for (unsigned rx = 0; rx < rings; ++rx) {
+        unsigned x0 = 2 + rx * step, y0 = 2 + ry * step, e = side - 1;
+        std::vector<sf::Vector2u> p;
+        for (unsigned i = 0; i < e; ++i) p.push_back({x0 + i, y0});
+        for (unsigned i = 0; i < e; ++i) p.push_back({x0 + e, y0 + i});
+        for (unsigned i = 0; i < e; ++i) p.push_back({x0 + e - i, y0 + e});
+        for (unsigned i = 0; i < e; ++i) p.push_back({x0, y0 + e - i});
+        for (auto t : p) map.setTile(t.x, t.y, TileMap::Rail);
+        loops.push_back(std::move(p));
+    }
+    std::streambuf* quiet = std::cerr.rdbuf(nullptr); // carts and textures log per call
+    ResourceManager res;
+    RailRouter router(map);
+    RailTraffic traffic(map);
+    std::vector<std::unique_ptr<Cart>> fleet;
+    std::vector<uint8_t> taken(extent * extent, 0);
+    const unsigned perRing = (carts + rings * rings - 1) / (rings * rings);
+    for (unsigned n = 0; n < carts; ++n) {
+        const auto &loop = loops[n % loops.size()];
+        unsigned k = (n / loops.size()) * loop.size() / perRing;
+        // start on plain track clear of junctions (carts never wait inside a junction block)
+        auto junctionAt = [&](unsigned i){ auto t = loop[i % loop.size()]; return std::bitset<4>(map.railBits(t.x, t.y)).count() >= 3; };
+        auto startable = [&](unsigned i){ for (unsigned j = 0; j <= 3; ++j) if (junctionAt(i + j)) return false; return !taken[loop[i].x + loop[i].y * extent]; };
+        while (!startable(k)) k = (k + 1) % loop.size();
+        taken[loop[k].x + loop[k].y * extent] = 1;
+        auto cart = std::make_unique<Cart>(res, sf::Vector2f(), map.tileSize());
+        cart->setTileMap(&map); cart->setRouter(&router);
+        cart->addStop(loop[k]);
+        for (unsigned c = 1; c <= 4; ++c) { unsigned corner = ((k / (side - 1) + c) % 4) * (side - 1); cart->addStop(loop[corner]); }
+        fleet.push_back(std::move(cart));
+    }
+    const sf::Time dt = sf::seconds(1.f / 60.f);
+    double trafficSec = 0.0, moveSec = 0.0, red = 0.0, yield = 0.0, travelled = 0.0;
+    unsigned overlapTicks = 0, conflicts = 0;
+    std::vector<sf::Vector2f> last(fleet.size()); std::vector<float> idle(fleet.size(), 0.f);
+    std::vector<uint32_t> occupied;
+    for (unsigned t = 0; t < ticks; ++t) {
+        for (size_t i = 0; i < fleet.size(); ++i) last[i] = fleet[i]->worldPosition();
+        auto t0 = BenchClock::now(); traffic.update(fleet, dt);
+        auto t1 = BenchClock::now(); for (auto &c : fleet) c->update(dt);
+        auto t2 = BenchClock::now();
+        trafficSec += std::chrono::duration<double>(t1 - t0).count(); moveSec += std::chrono::duration<double>(t2 - t1).count();
+        red += traffic.lastStats().red; yield += traffic.lastStats().yield; conflicts += traffic.lastStats().conflicts;
+        occupied.clear();
+        for (size_t i = 0; i < fleet.size(); ++i) {
+            sf::Vector2f p = fleet[i]->worldPosition(), d = p - last[i];
+            float moved = std::abs(d.x) + std::abs(d.y);
+            travelled += moved; idle[i] = moved > 0.f ? 0.f : idle[i] + dt.asSeconds();
+            occupied.push_back(unsigned(p.x / 32.f) + unsigned(p.y / 32.f) * extent);
+        }
+        std::sort(occupied.begin(), occupied.end());
+        if (std::adjacent_find(occupied.begin(), occupied.end()) != occupied.end()) ++overlapTicks;
+    }
+    std::cerr.rdbuf(quiet);
+    unsigned stalled = (unsigned)std::count_if(idle.begin(), idle.end(), [](float s){ return s > 10.f; });
+    nlohmann::json out; out["bench"] = "traffic"; out["carts"] = fleet.size(); out["ticks"] = ticks;
+    out["rail_tiles"] = map.rails().tileCount();
+    out["traffic_ms_per_tick"] = trafficSec * 1000.0 / ticks;
+    out["cart_update_ms_per_tick"] = moveSec * 1000.0 / ticks;
+    out["avg_red"] = red / ticks; out["avg_yield"] = yield / ticks;
+    out["tiles_travelled_per_cart"] = travelled / 32.0 / fleet.size();
+    out["ticks_with_shared_tile"] = overlapTicks; out["hold_conflicts"] = conflicts;
+    out["stalled_over_10s"] = stalled; // gridlock check
+    out["route_searches"] = router.searches(); out["route_cache_hits"] = router.cacheHits();
+    return out;
+}
+
+// spatial: projectile-vs-hostile hit resolution as PlayState does it (swept segment vs grown bounds),
+// brute force over every body vs candidates from SpatialHash, at 1k..10k bodies with one shot per
+// ten bodies and constant density; bodies jitter each tick so the hash pays its re-bucketing too
+namespace {
+struct BenchBody : Entity {
+    sf::FloatRect box;
+    void update(sf::Time) override {}
+    void draw(sf::RenderWindow&) override {}
+    sf::FloatRect getBounds() const override { return box; }
+    void interact(Entity*) override {}
+};
+}
+
+static nlohmann::json benchSpatial() {
+    const unsigned counts[] = {1000, 2500, 5000, 10000};
+    const int ticks = 60;
+    const float r = 4.f, step = 5.f; // projectile radius, px per tick (300 px/s at 60 Hz)
+    nlohmann::json out; out["bench"] = "spatial"; out["ticks"] = ticks;
+    for (unsigned n : counts) {
+        const unsigned shots = n / 10;
+        const float side = std::sqrt(float(n)) * 64.f; // ~one body per 64x64 px
+        std::mt19937 rng(n);
+        std::uniform_real_distribution<float> pos(0.f, side), jit(-1.f, 1.f), ang(0.f, 6.2831853f);
+        std::vector<BenchBody> bodies(n);
+        for (auto &b : bodies) b.box = {{pos(rng), pos(rng)}, {24.f, 24.f}};
+        std::vector<sf::Vector2f> from(shots), vel(shots);
+        for (unsigned i = 0; i < shots; ++i) { from[i] = {pos(rng), pos(rng)}; float a = ang(rng); vel[i] = {std::cos(a) * step, std::sin(a) * step}; }
+        SpatialHash grid(64.f);
+        for (auto &b : bodies) grid.insert(&b, b.box, 1u);
+        auto hitOf = [&](sf::Vector2f a, sf::Vector2f b, const sf::FloatRect& hb, float& bestT) {
+            float t; sf::FloatRect grown({hb.position.x - r, hb.position.y - r}, {hb.size.x + 2.f*r, hb.size.y + 2.f*r});
+            if (segmentIntersectsRect(a, b, grown, &t) && t < bestT) { bestT = t; return true; }
+            return false;
+        };
+        double bruteSec = 0.0, hashSec = 0.0, syncSec = 0.0; size_t bruteHits = 0, hashHits = 0, candidates = 0;
+        std::vector<Entity*> near;
+        for (int t = 0; t < ticks; ++t) {
+            for (auto &b : bodies) b.box.position += sf::Vector2f{jit(rng), jit(rng)};
+            auto t0 = BenchClock::now();
+            for (auto &b : bodies) grid.update(&b, b.box);
+            auto t1 = BenchClock::now();
+            for (unsigned i = 0; i < shots; ++i) {
+                sf::Vector2f a = from[i], b = a + vel[i]; const Entity* target = nullptr; float bestT = 2.f;
+                for (auto &body : bodies) if (hitOf(a, b, body.box, bestT)) target = &body;
+                bruteHits += target != nullptr;
+            }
+            auto t2 = BenchClock::now();
+            for (unsigned i = 0; i < shots; ++i) {
+                sf::Vector2f a = from[i], b = a + vel[i]; const Entity* target = nullptr; float bestT = 2.f;
+                grid.queryRect({{std::min(a.x,b.x) - r, std::min(a.y,b.y) - r}, {std::abs(b.x-a.x) + 2.f*r, std::abs(b.y-a.y) + 2.f*r}}, 1u, near);
+                candidates += near.size();
+                for (Entity* e : near) if (hitOf(a, b, e->getBounds(), bestT)) target = e;
+                hashHits += target != nullptr;
+            }
+            auto t3 = BenchClock::now();
+            syncSec += std::chrono::duration<double>(t1 - t0).count();
+            bruteSec += std::chrono::duration<double>(t2 - t1).count();
+            hashSec += std::chrono::duration<double>(t3 - t2).count();
+            for (unsigned i = 0; i < shots; ++i) from[i] += vel[i];
+        }
+        nlohmann::json row;
+        row["bodies"] = n; row["shots"] = shots;
+        row["brute_ms_per_tick"] = bruteSec * 1000.0 / ticks;
+        row["hash_query_ms_per_tick"] = hashSec * 1000.0 / ticks;
+        row["hash_sync_ms_per_tick"] = syncSec * 1000.0 / ticks;
+        row["speedup"] = bruteSec / std::max(1e-12, hashSec + syncSec);
+        row["candidates_per_shot"] = double(candidates) / (double(shots) * ticks);
+        row["hits_match"] = bruteHits == hashHits; row["hits"] = hashHits;
+        out["results"].push_back(row);
+    }
+    return out;
+}
+
+// crops: 100k planted tiles (wheat from data/crops.json) on a 512x512 map with varied soil, one
+// Crop entity per tile (the old per-entity update) vs one CropField pass, 600 ticks at 60 Hz
+static nlohmann::json benchCrops() {
+    const unsigned side = 512, count = 100000, ticks = 600;
+    std::streambuf* quiet = std::cerr.rdbuf(nullptr); // config loading and withering log per crop
+    ResourceManager res;
+    Crop::loadConfigs(res, "data/crops.json");
+    TileMap map(side, side, 32);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> wet(0.1f, 0.9f), fert(-0.4f, 0.3f);
+    for (unsigned i = 0; i < count; ++i) { unsigned x = i % side, y = i / side; map.addWater(x, y, wet(rng)); map.adjustFertility(x, y, fert(rng)); }
+    std::vector<std::unique_ptr<Crop>> entities;
+    CropField field(map);
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned x = i % side, y = i / side;
+        entities.push_back(std::make_unique<Crop>(res, map, sf::Vector2f((x + 0.5f) * 32.f, (y + 0.5f) * 32.f), "wheat", 3, 6.f));
+        field.plant(x, y, "wheat");
+    }
+    const sf::Time dt = sf::seconds(1.f / 60.f);
+    double entitySec = 0.0, fieldSec = 0.0;
+    for (unsigned t = 0; t < ticks; ++t) {
+        map.updateSoil(dt); // soil keeps relaxing, so crops on drifting tiles keep re-reading it
+        auto t0 = BenchClock::now(); for (auto &c : entities) c->update(dt);
+        auto t1 = BenchClock::now(); field.update(dt);
+        auto t2 = BenchClock::now();
+        entitySec += std::chrono::duration<double>(t1 - t0).count(); fieldSec += std::chrono::duration<double>(t2 - t1).count();
+    }
+    std::cerr.rdbuf(quiet);
+    unsigned witheredEntities = 0, witheredField = 0, ripeEntities = 0, ripeField = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        witheredEntities += entities[i]->isWithered(); witheredField += field.withered(int(i));
+        ripeEntities += entities[i]->isRipe(); ripeField += field.ripe(int(i));
+    }
+    nlohmann::json out; out["bench"] = "crops"; out["crops"] = count; out["ticks"] = ticks;
+    out["entity_ms_per_tick"] = entitySec * 1000.0 / ticks;
+    out["field_ms_per_tick"] = fieldSec * 1000.0 / ticks;
+    out["speedup"] = entitySec / std::max(1e-12, fieldSec);
+    out["withered_entities"] = witheredEntities; out["withered_field"] = witheredField; out["ripe_entities"] = ripeEntities; out["ripe_field"] = ripeField;
+    out["field_pending_events"] = field.pendingEvents();
+    return out;
+}
+
+// fastforward: a day (PlayState's default dayLength, 600 s) of a 7560-crop farm on drifting soil with 20
+// carts looping four rings (two of them joined by a spur) through two loader/unloader pairs, once as fixed 1/60 s ticks in
+// PlayState::update's order and once through FastForward. Reports both timings and how far the
+// fast-forwarded world ends up from the ticked one.
+namespace {
+struct FarmScene {
+    static constexpr float Batch = 0.1f; // PlayState::logisticsBatch
+    TileMap map{120, 120, 32};
+    RailRouter router{map};
+    RailTraffic traffic{map};
+    CropField crops{map};
+    Logistics logistics;
+    Inventory seeds{8};
+    std::vector<std::unique_ptr<Cart>> carts;
+    float batchTimer = 0.f;
+    unsigned delivered = 0;
+
+    explicit FarmScene(ResourceManager& res) {
+        for (unsigned r = 0; r < 4; ++r) {
+            unsigned x0 = 2 + r * 25, y0 = 2, e = 20;
+            std::vector<sf::Vector2u> p; // clockwise perimeter
+            for (unsigned i = 0; i < e; ++i) p.push_back({x0 + i, y0});
+            for (unsigned i = 0; i < e; ++i) p.push_back({x0 + e, y0 + i});
+            for (unsigned i = 0; i < e; ++i) p.push_back({x0 + e - i, y0 + e});
+            for (unsigned i = 0; i < e; ++i) p.push_back({x0, y0 + e - i});
+            for (auto t : p) map.setTile(t.x, t.y, TileMap::Rail);
+            if (r % 2 == 0) { // a loader feeding from one shared stock, an unloader into its own buffer
+                int l = logistics.addStation(Logistics::Kind::Loader, p[10], 4.f, &seeds);
+                logistics.station(l)->filter = "seed_wheat";
+                logistics.addStation(Logistics::Kind::Unloader, p[50], 4.f);
+            }
+            for (unsigned k = 0; k < 5; ++k) {
+                auto c = std::make_unique<Cart>(res, sf::Vector2f(), map.tileSize());
+                c->setTileMap(&map); c->setRouter(&router); c->setSpeed(45.f + 7.f * k);
+                for (unsigned s = 0; s < 4; ++s) c->addStop(p[(k * 16 + s * 20) % p.size()]);
+                carts.push_back(std::move(c));
+            }
+        }
+        for (unsigned x = 23; x < 27; ++x) map.setTile(x, 12, TileMap::Rail); // spur between rings 0 and 1: two junctions
+        seeds.addItem(std::make_shared<Item>("seed_wheat", "Wheat Seeds", "", 5000));
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> wet(0.f, 0.9f), fert(-0.4f, 0.3f);
+        for (unsigned y = 40; y < 110; ++y) for (unsigned x = 2; x < 110; ++x) {
+            map.addWater(x, y, wet(rng)); map.adjustFertility(x, y, fert(rng));
+            crops.plant(x, y, (x + y) % 3 ? "wheat" : "herb");
+        }
+    }
+    void tick(sf::Time dt) { // the soil / crop / cart / logistics part of PlayState::update
+        map.updateSoil(dt);
+        crops.update(dt);
+        traffic.update(carts, dt);
+        for (auto &c : carts) c->update(dt);
+        batchTimer += dt.asSeconds();
+        while (batchTimer >= Batch) { batchTimer -= Batch; delivered += logistics.update(carts, sf::seconds(Batch), map.tileSize()).second; }
+    }
+};
+}
+
+static nlohmann::json benchFastForward() {
+    const float day = 600.f;
+    const unsigned ticks = unsigned(std::lround(day * 60.f));
+    std::streambuf* quiet = std::cerr.rdbuf(nullptr); // carts, configs and withering log
+    ResourceManager res;
+    Crop::loadConfigs(res, "data/crops.json");
+    FarmScene fixed(res), skipped(res);
+    const sf::Time dt = sf::seconds(1.f / 60.f);
+    auto t0 = BenchClock::now();
+    for (unsigned t = 0; t < ticks; ++t) fixed.tick(dt);
+    auto t1 = BenchClock::now();
+    FastForward ff(skipped.map, skipped.crops, skipped.traffic, skipped.logistics);
+    skipped.delivered = ff.run(skipped.carts, day, FarmScene::Batch, skipped.batchTimer);
+    auto t2 = BenchClock::now();
+    std::cerr.rdbuf(quiet);
+    float cartOffset = 0.f, soilDiff = 0.f;
+    unsigned cargoMismatches = 0, heldMismatches = 0, stageMismatches = 0, witherMismatches = 0;
+    for (size_t i = 0; i < fixed.carts.size(); ++i) {
+        const Cart &a = *fixed.carts[i], &b = *skipped.carts[i];
+        sf::Vector2f d = a.worldPosition() - b.worldPosition();
+        cartOffset = std::max(cartOffset, std::hypot(d.x, d.y));
+        cargoMismatches += a.itemsCount() != b.itemsCount();
+        heldMismatches += a.isHeld() != b.isHeld();
+    }
+    for (unsigned y = 0; y < fixed.map.height(); ++y) for (unsigned x = 0; x < fixed.map.width(); ++x) {
+        soilDiff = std::max({soilDiff, std::abs(fixed.map.moisture(x, y) - skipped.map.moisture(x, y)), std::abs(fixed.map.fertility(x, y) - skipped.map.fertility(x, y))});
+        int a = fixed.crops.cropAt(x, y), b = skipped.crops.cropAt(x, y);
+        stageMismatches += fixed.crops.growthStage(a) != skipped.crops.growthStage(b);
+        witherMismatches += fixed.crops.withered(a) != skipped.crops.withered(b);
+    }
+    const FastForward::Stats &st = ff.lastStats();
+    nlohmann::json out; out["bench"] = "fastforward"; out["seconds"] = day; out["ticks"] = ticks;
+    out["crops"] = fixed.crops.size(); out["carts"] = fixed.carts.size();
+    out["fixed_ms"] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    out["fastforward_ms"] = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    out["speedup"] = std::chrono::duration<double>(t1 - t0).count() / std::max(1e-12, std::chrono::duration<double>(t2 - t1).count());
+    out["traffic_passes"] = st.passes; out["cart_updates"] = st.cartSteps; out["logistics_batches"] = st.batches;
+    out["max_cart_offset_px"] = cartOffset;
+    out["cart_cargo_mismatches"] = cargoMismatches; out["cart_hold_mismatches"] = heldMismatches;
+    out["delivered_fixed"] = fixed.delivered; out["delivered_fastforward"] = skipped.delivered;
+    out["max_soil_diff"] = soilDiff;
+    out["crop_stage_mismatches"] = stageMismatches; out["crop_wither_mismatches"] = witherMismatches;
+    return out;
+}
+
+nlohmann::json runBenchmark(const std::string& name) {
+    if (name == "soil") return benchSoil();
+    if (name == "collision") return benchCollision();
+    if (name == "rays") return benchRays();
+    if (name == "paths") return benchPaths(false);
+    if (name == "paths_noise") return benchPaths(true);
+    if (name == "rail_components") return benchRailComponents();
+    if (name == "rail_routes") return benchRailRoutes();
+    if (name == "traffic") return benchTraffic();
+    if (name == "spatial") return benchSpatial();
+    if (name == "crops") return benchCrops();
+    if (name == "fastforward") return benchFastForward();
+    return { {"error", "unknown benchmark '" + name + "'"}, {"known", {"soil", "collision", "rays", "paths", "paths_noise", "rail_components", "rail_routes", "traffic", "spatial", "crops", "fastforward"}} };
+}
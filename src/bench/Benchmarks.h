@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+#include <nlohmann/json.hpp>
+
+// Headless micro-benchmarks (run with: sfml-game-framework-headless --bench <name>).
+// Each returns a json report; an unknown name returns {"error": ...} listing the known ones.
+nlohmann::json runBenchmark(const std::string& name);
@@ -4,6 +4,7 @@
 #include "../resources/ResourceManager.h"
 #include "../input/InputManager.h"
 #include "../systems/SoundManager.h"
+#include "Tunables.h"
 #include <variant>
 #include <type_traits>
 #include <nlohmann/json.hpp>
@@ -72,13 +73,7 @@ extern void LoadItemDefinitions(const std::string& path);
 extern bool LoadCustomBindings(InputManager& input, const std::string& path);
 extern void SaveCustomBindings(const InputManager& input, const std::string& path);
 
-struct Tunables { nlohmann::json j; };
-Tunables g_tunables; // remove static to allow accessor
-nlohmann::json* g_getTunablesJson() { return g_tunables.j.is_null()? nullptr : &g_tunables.j; }
-static void loadTunables(const std::string& path) {
-    std::ifstream is(path); if(!is) { std::cerr << "No tunables file: "<<path<<"\n"; return; }
-    try { is >> g_tunables.j; std::cerr << "Loaded tunables keys="<<g_tunables.j.size()<<"\n"; } catch(...) { std::cerr << "Failed tunables parse\n"; }
-}
+static const char* TunablesPath = "data/tunables.json";
 
 Game::Game()
 : window(sf::VideoMode({1024u, 768u}), "Top-down Game Framework")
@@ -91,18 +86,8 @@ Game::Game()
     applyDefaultBindings(*inputManager);
     LoadCustomBindings(*inputManager, "bindings.saved.json");
     LoadItemDefinitions("data/items_basic.json");
-    loadTunables("data/tunables.json");
-    // Apply global tunables that affect world systems (soil)
-    if (auto *tj = g_getTunablesJson()) {
-        if ((*tj).contains("soil")) {
-            auto &sj = (*tj)["soil"];
-            float moistTarget = sj.value("moisture_target", 0.3f);
-            float moistDecay = sj.value("moisture_decay_per_sec", 0.02f);
-            float fertTarget = sj.value("fertility_target", 0.5f);
-            float fertRegen = sj.value("fertility_regen_per_sec", 0.005f);
-            // defer applying until PlayState constructed and map accessible (handled inside PlayState after creation if needed)
-        }
-    }
+    loadTunables(TunablesPath);
+    tunablesWatcher = std::make_unique<TunablesWatcher>(TunablesPath);
     currentState = std::make_unique<PlayState>(*this);
     window.setFramerateLimit(60);
 }
@@ -150,6 +135,7 @@ void Game::processEvents() {
 void Game::update(sf::Time dt) {
     // sample current keyboard state so entities can query input during update
     inputManager->poll();
+    pollTunables();
 
     if (currentState) currentState->update(dt);
 }
@@ -167,8 +153,14 @@ void Game::setState(std::unique_ptr<State> s) { currentState = std::move(s); }
 void Game::pushTemporaryState(std::unique_ptr<State> s) { savedState = std::move(currentState); currentState = std::move(s); }
 void Game::popTemporaryState() { if (savedState) { currentState = std::move(savedState); } }
 
+// live tuning: an edited tunables file is reparsed and swapped in between ticks, never mid-update
+void Game::pollTunables() {
+    if (tunablesWatcher && tunablesWatcher->changed()) loadTunables(tunablesWatcher->path());
+}
+
 void Game::step(float dtSeconds) {
     // Poll input snapshot (no events in headless mode yet)
     inputManager->poll();
+    pollTunables();
     if (currentState) currentState->update(sf::seconds(dtSeconds));
 }
\ No newline at end of file
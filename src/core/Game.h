@@ -8,6 +8,7 @@ class State;
 class ResourceManager;
 class InputManager;
 class SoundManager;
+class TunablesWatcher;
 
 class Game {
 public:
@@ -28,6 +29,7 @@ private:
   void processEvents();
   void update(sf::Time dt);
   void render();
+  void pollTunables();  // reload data/tunables.json at the tick boundary when it changed
 
   sf::RenderWindow window;
   std::unique_ptr<State> currentState;
@@ -35,5 +37,6 @@ private:
   std::unique_ptr<ResourceManager> resourceManager;
   std::unique_ptr<InputManager> inputManager;
   std::unique_ptr<SoundManager> soundManager;
+  std::unique_ptr<TunablesWatcher> tunablesWatcher;
   sf::View camera;
 };
\ No newline at end of file
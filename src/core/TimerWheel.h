@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <cstddef>
+
+// Hierarchical timing wheel over integer ticks. Level 0 has one slot per tick (256 ticks); each higher
+// level has 64 slots spanning a whole turn of the level below and is cascaded down when that level
+// wraps, so schedule() is O(1) and advance() costs O(1) per tick plus the events it fires (each event
+// is moved at most once per level). There is no cancel: callers stamp payloads (generation counters)
+// and drop stale ones when they fire. Events further out than the top level are parked at its far
+// edge and re-filed when they surface.
+template<class T>
+class TimerWheel {
+public:
+    void schedule(uint64_t due, T payload) { place(Entry{due, std::move(payload)}, current + 1); ++count; } // overdue: next tick
+
+    // fire(payload, due) for every event with due <= tick, in tick order; fire may schedule again
+    template<class F> void advance(uint64_t tick, F&& fire) {
+        while (current < tick) {
+            ++current;
+            // cascade: when level l-1 wraps, its next turn comes from the level-l slot for this tick
+            for (unsigned l = 1; l < Levels && (current & ((uint64_t(1) << shift(l)) - 1)) == 0; ++l) {
+                auto moved = std::move(levels[l][slotOf(current, l)]);
+                levels[l][slotOf(current, l)].clear();
+                for (auto &e : moved) place(std::move(e), current);
+            }
+            auto &slot = levels[0][current & (L0Slots - 1)];
+            if (slot.empty()) continue;
+            fired.swap(slot);
+            for (auto &e : fired) {
+                if (e.due > current) { place(std::move(e), current + 1); continue; } // parked past the top level
+                --count; fire(e.payload, e.due);
+            }
+            fired.clear();
+        }
+    }
+
+    void clear(uint64_t tick = 0) { for (auto &lv : levels) for (auto &s : lv) s.clear(); current = tick; count = 0; }
+    uint64_t now() const { return current; }
+    size_t pending() const { return count; } // includes stale events not yet fired
+
+private:
+    struct Entry { uint64_t due; T payload; };
+    static constexpr unsigned Levels = 4, L0Bits = 8, LnBits = 6;
+    static constexpr unsigned L0Slots = 1u << L0Bits, LnSlots = 1u << LnBits;
+    static constexpr unsigned shift(unsigned l) { return l == 0 ? 0 : L0Bits + (l - 1) * LnBits; }
+    static constexpr uint64_t Span = uint64_t(1) << (L0Bits + (Levels - 1) * LnBits); // ticks the wheel can hold
+    static unsigned slotOf(uint64_t t, unsigned l) { return unsigned(t >> shift(l)) & ((l == 0 ? L0Slots : LnSlots) - 1); }
+
+    // file under the slot for max(due, from); from is the first tick whose level-0 slot is still to be processed
+    void place(Entry e, uint64_t from) {
+        uint64_t t = e.due < from ? from : e.due;
+        if (t - current >= Span) t = current + Span - 1;
+        unsigned l = 0;
+        while (l + 1 < Levels && (t - current) >= (uint64_t(1) << shift(l + 1))) ++l;
+        levels[l][slotOf(t, l)].push_back(std::move(e));
+    }
+
+    std::array<std::vector<std::vector<Entry>>, Levels> levels{ {std::vector<std::vector<Entry>>(L0Slots), std::vector<std::vector<Entry>>(LnSlots), std::vector<std::vector<Entry>>(LnSlots), std::vector<std::vector<Entry>>(LnSlots)} };
+    std::vector<Entry> fired;
+    uint64_t current = 0;
+    size_t count = 0;
+};
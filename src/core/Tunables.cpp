@@ -0,0 +1,108 @@
+#include "Tunables.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+static Tunables g_tunables;
+const Tunables& tunables() { return g_tunables; }
+
+// keys that are absent keep the default; a key of the wrong type throws and fails the whole load
+template<class T> static void readKey(const nlohmann::json& j, const char* key, T& v) { if (j.contains(key)) v = j[key].get<T>(); }
+static const nlohmann::json& section(const nlohmann::json& j, const char* key) {
+    static const nlohmann::json empty = nlohmann::json::object();
+    auto it = j.find(key); return it != j.end() && it->is_object() ? *it : empty;
+}
+
+static void readHostile(const nlohmann::json& j, Tunables::Hostile& h) {
+    readKey(j, "speed", h.speed); readKey(j, "health", h.health); readKey(j, "contact_damage", h.contactDamage);
+    readKey(j, "rage_speed_mult", h.rageSpeedMult); readKey(j, "rage_duration", h.rageDuration);
+}
+
+bool loadTunables(const std::string& path) {
+    std::ifstream is(path); if (!is) { std::cerr << "No tunables file: " << path << "\n"; return false; }
+    Tunables t;
+    try {
+        nlohmann::json j; is >> j;
+        if (!j.is_object()) throw std::runtime_error("top level is not an object");
+        auto &w = section(j, "world"); readKey(w, "width", t.world.width); readKey(w, "height", t.world.height);
+        auto &p = section(j, "player");
+        readKey(p, "speed", t.player.speed); readKey(p, "regen_rate", t.player.regenRate); readKey(p, "regen_delay", t.player.regenDelay);
+        readKey(p, "regen_curve_exponent", t.player.regenCurveExponent); readKey(p, "base_damage", t.player.baseDamage);
+        auto &h = section(j, "hostile");
+        readKey(h, "flow_radius", t.hostile.flowRadius);
+        readHostile(section(h, "grunt"), t.hostile.grunt); readHostile(section(h, "tank"), t.hostile.tank);
+        auto &pr = section(j, "projectile");
+        readKey(pr, "speed", t.projectile.speed); readKey(pr, "knockback", t.projectile.knockback); readKey(pr, "lifetime", t.projectile.lifetime);
+        auto &f = section(j, "farming");
+        for (auto &kv : section(f, "base_growth_seconds").items()) t.farming.baseGrowthSeconds[kv.key()] = kv.value().get<float>();
+        readKey(f, "moisture_factor", t.farming.moistureFactor); readKey(f, "fertility_factor", t.farming.fertilityFactor);
+        readKey(f, "yield_bonus_scale", t.farming.yieldBonusScale);
+        auto &l = section(j, "logistics");
+        readKey(l, "loader_items_per_sec", t.logistics.loaderItemsPerSec); readKey(l, "unloader_items_per_sec", t.logistics.unloaderItemsPerSec);
+        readKey(l, "batch_seconds", t.logistics.batchSeconds);
+        readKey(section(j, "lighting"), "lightmap_downscale", t.lighting.lightmapDownscale);
+        auto &s = section(j, "soil");
+        readKey(s, "moisture_target", t.soil.moistureTarget); readKey(s, "moisture_decay_per_sec", t.soil.moistureDecayPerSec);
+        readKey(s, "fertility_target", t.soil.fertilityTarget); readKey(s, "fertility_regen_per_sec", t.soil.fertilityRegenPerSec);
+        readKey(s, "mode", t.soil.mode);
+    } catch (std::exception& e) { std::cerr << "Failed tunables parse (" << path << "): " << e.what() << "\n"; return false; }
+    t.version = g_tunables.version + 1;
+    g_tunables = std::move(t);
+    std::cerr << "Loaded tunables v" << g_tunables.version << " from " << path << "\n";
+    return true;
+}
+
+static int64_t nowMs() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+TunablesWatcher::TunablesWatcher(const std::string& path, float pollSeconds) : file(path), pollSeconds(pollSeconds) {
+    std::error_code ec; mtime = std::filesystem::last_write_time(file, ec);
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        std::string dir = std::filesystem::path(file).parent_path().string();
+        if (inotify_add_watch(fd, dir.empty() ? "." : dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) { close(fd); fd = -1; }
+    }
+    if (fd < 0) std::cerr << "[Tunables] inotify unavailable, polling " << file << "\n";
+#endif
+}
+
+TunablesWatcher::~TunablesWatcher() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool TunablesWatcher::mtimeChanged() {
+    int64_t now = nowMs();
+    if (now < nextPollMs) return false;
+    nextPollMs = now + int64_t(pollSeconds * 1000.f);
+    std::error_code ec; auto t = std::filesystem::last_write_time(file, ec);
+    if (ec || t == mtime) return false;
+    mtime = t; return true;
+}
+
+bool TunablesWatcher::changed() {
+#ifdef __linux__
+    if (fd >= 0) {
+        // drain every queued event; several writes in one tick collapse into one reload
+        std::string name = std::filesystem::path(file).filename().string();
+        alignas(inotify_event) char buf[4096];
+        bool hit = false;
+        for (ssize_t n; (n = ::read(fd, buf, sizeof(buf))) > 0; ) {
+            for (char* p = buf; p < buf + n; ) {
+                auto *ev = reinterpret_cast<inotify_event*>(p);
+                if (ev->len && std::strcmp(ev->name, name.c_str()) == 0) hit = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        return hit;
+    }
+#endif
+    return mtimeChanged();
+}
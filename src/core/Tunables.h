@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <filesystem>
+
+// data/tunables.json parsed once into plain fields, so per-tick code reads tunables().farming.moistureFactor
+// instead of indexing JSON by string. Field defaults are what the game used when a key was missing.
+// `version` bumps on every successful (re)load; systems that bake tunables into their own state compare it.
+struct Tunables {
+    struct World { unsigned width = 50, height = 30; };
+    struct Player { float speed = 200.f, regenRate = 5.f, regenDelay = 2.f, regenCurveExponent = 0.f, baseDamage = 10.f; };
+    struct Hostile { float speed = 60.f, health = 10.f, contactDamage = 8.f, rageSpeedMult = 1.f, rageDuration = 0.f; };
+    struct Hostiles { unsigned flowRadius = 64; Hostile grunt, tank; };
+    struct Projectile { float speed = 300.f, knockback = 0.f, lifetime = 2.f; };
+    struct Farming {
+        std::unordered_map<std::string, float> baseGrowthSeconds; // per crop id
+        float moistureFactor = 1.f, fertilityFactor = 1.f, yieldBonusScale = 2.f;
+        float growthSeconds(const std::string& id, float def) const { auto it = baseGrowthSeconds.find(id); return it == baseGrowthSeconds.end() ? def : it->second; }
+    };
+    struct Logistics { float loaderItemsPerSec = 4.f, unloaderItemsPerSec = 4.f, batchSeconds = 0.1f; };
+    struct Lighting { unsigned lightmapDownscale = 4; };
+    struct Soil { float moistureTarget = 0.3f, moistureDecayPerSec = 0.02f, fertilityTarget = 0.5f, fertilityRegenPerSec = 0.005f; std::string mode = "active"; };
+
+    World world; Player player; Hostiles hostile; Projectile projectile; Farming farming;
+    Logistics logistics; Lighting lighting; Soil soil;
+    uint32_t version = 0; // 0 = built-in defaults, nothing loaded yet
+};
+
+const Tunables& tunables();
+// parse path into a fresh Tunables and swap it in whole; on a missing/bad file the current values stay
+bool loadTunables(const std::string& path);
+
+// Notices edits to one file: inotify on its directory where available (catches editors that save by
+// rename), otherwise an mtime check every pollSeconds. changed() never blocks; call it between ticks.
+class TunablesWatcher {
+public:
+    explicit TunablesWatcher(const std::string& path, float pollSeconds = 0.5f);
+    ~TunablesWatcher();
+    TunablesWatcher(const TunablesWatcher&) = delete;
+    TunablesWatcher& operator=(const TunablesWatcher&) = delete;
+    bool changed();
+    const std::string& path() const { return file; }
+
+private:
+    bool mtimeChanged();
+    std::string file;
+    int fd = -1; // inotify instance, -1 when polling
+    std::filesystem::file_time_type mtime{};
+    float pollSeconds;
+    int64_t nextPollMs = 0;
+};
@@ -1,12 +1,12 @@
 #include "Cart.h"
 #include "Rail.h"
 #include "../world/TileMap.h"
+#include "../world/RailRouter.h"
 #include "../resources/ResourceManager.h"
 #include "Player.h" // for rider control
 #include <cmath>
+#include <algorithm>
 #include <iostream>
-#include <queue>
-#include <unordered_set>
 
 Cart::Cart(ResourceManager& res, const sf::Vector2f& pos, unsigned tileSize)
 : sprite(res.texture("assets/textures/entities/tiles/cart.png"))
@@ -46,9 +46,105 @@ void Cart::addWaypoint(const sf::Vector2u& tile) {
     waypoints.push_back(tile);
 }
 
+bool Cart::addStop(const sf::Vector2u& tile) {
+    if (!map || !router) { std::cerr << "Cart: no map/router set, cannot add stop.\n"; return false; }
+    if (!map->isTileRail(tile.x, tile.y)) { std::cerr << "Stop rejected: not a rail tile ("<<tile.x<<","<<tile.y<<")\n"; return false; }
+    if (!stops.empty() && stops.back() == tile) { std::cerr << "Stop duplicate ignored.\n"; return false; }
+    if (!stops.empty() && !map->rails().connected(stops.back().x, stops.back().y, tile.x, tile.y)) {
+        std::cerr << "Stop rejected: no rail path from previous stop.\n"; return false;
+    }
+    if (stops.empty()) { // snap onto the first stop like addWaypoint does (before planning, which resumes from the cart)
+        float ts = (float)map->tileSize();
+        targetPos = { tile.x * ts + ts*0.5f, tile.y * ts + ts*0.5f };
+        body.setPosition(targetPos);
+        sprite.setPosition(targetPos);
+    }
+    stops.push_back(tile);
+    replan();
+    return true;
+}
+
+bool Cart::replan() {
+    routedVersion = router->version();
+    sf::Vector2f pos = body.getPosition();
+    waypoints.clear(); current = 0; loopFrom = 0;
+    routeCut = !map->isTileRail(stops[0].x, stops[0].y);
+    if (routeCut) return false;
+    // waypoints stay a chain of adjacent rail tiles: the route ends at the last stop it can still reach
+    size_t legs = stops.size() - 1 + (loopPath && stops.size() > 1 ? 1 : 0);
+    waypoints.push_back(stops[0]);
+    for (size_t i = 0; i < legs && !routeCut; ++i) {
+        auto r = router->route(stops[i], stops[(i + 1) % stops.size()]);
+        if (r->empty()) routeCut = true;
+        else waypoints.insert(waypoints.end(), r->begin() + 1, r->end());
+    }
+    if (!routeCut && loopPath && waypoints.size() > 1 && waypoints.back() == waypoints.front()) waypoints.pop_back();
+    // resume from the waypoint nearest the cart; one more than a tile away is reached along the rails from the
+    // cart's own tile (a lead-in the route does not wrap back to), never in a straight line across the map
+    float ts = (float)map->tileSize(), best = -1.f;
+    for (size_t i = 0; i < waypoints.size(); ++i) {
+        sf::Vector2f d = sf::Vector2f(waypoints[i].x * ts + ts*0.5f, waypoints[i].y * ts + ts*0.5f) - pos;
+        float dd = d.x*d.x + d.y*d.y;
+        if (best < 0.f || dd < best) { best = dd; current = i; }
+    }
+    if (best > ts*ts*1.0001f) {
+        sf::Vector2u at{ (unsigned)std::max(0.f, pos.x / ts), (unsigned)std::max(0.f, pos.y / ts) };
+        auto lead = router->route(at, waypoints[current]);
+        if (lead->empty()) { waypoints.clear(); current = 0; return false; } // cut off from its route: stay put
+        std::vector<sf::Vector2u> route(lead->begin(), lead->end() - 1);
+        loopFrom = route.size();
+        route.insert(route.end(), waypoints.begin() + current, waypoints.end());
+        if (loopPath && !routeCut) route.insert(route.end(), waypoints.begin(), waypoints.begin() + current);
+        waypoints.swap(route); current = 0;
+    }
+    targetPos = { waypoints[current].x * ts + ts*0.5f, waypoints[current].y * ts + ts*0.5f };
+    return !routeCut;
+}
+
+unsigned Cart::loadUnits(const Item& proto, unsigned n) {
+    size_t used = itemsCount();
+    n = (unsigned)std::min<size_t>(n, used < capacity ? capacity - used : 0);
+    if (!n) return 0;
+    for (auto &it : contents) if (it && it->id == proto.id) { it->stackSize += (int)n; return n; }
+    contents.push_back(std::make_shared<Item>(proto.id, proto.name, proto.description, (int)n));
+    return n;
+}
+
+ItemPtr Cart::unloadUnits(const std::string& filter, unsigned n) {
+    for (auto it = contents.rbegin(); it != contents.rend(); ++it) {
+        ItemPtr &stack = *it;
+        if (!stack || (!filter.empty() && stack->id != filter)) continue;
+        if ((unsigned)stack->stackSize <= n) { ItemPtr out = stack; contents.erase(std::next(it).base()); return out; }
+        stack->stackSize -= (int)n;
+        return std::make_shared<Item>(stack->id, stack->name, stack->description, (int)n);
+    }
+    return nullptr;
+}
+
+bool Cart::routeAhead(size_t ahead, sf::Vector2u& out) const {
+    if (waypoints.empty()) return false;
+    size_t i = current + ahead;
+    if (i >= waypoints.size()) { if (!loopPath || routeCut) return false; i = loopFrom + (i - loopFrom) % (waypoints.size() - loopFrom); }
+    out = waypoints[i]; return true;
+}
+
+bool Cart::atTileCenter() const {
+    if (!map) return true;
+    float ts = (float)map->tileSize();
+    sf::Vector2f p = body.getPosition();
+    sf::Vector2f c{ std::floor(p.x / ts) * ts + ts*0.5f, std::floor(p.y / ts) * ts + ts*0.5f };
+    return std::abs(p.x - c.x) < 0.5f && std::abs(p.y - c.y) < 0.5f;
+}
+
+float Cart::timeToTarget() const {
+    if (!map || waypoints.empty() || held || speed <= 0.f) return -1.f;
+    sf::Vector2f d = targetPos - body.getPosition();
+    return std::max(0.f, std::sqrt(d.x*d.x + d.y*d.y) - 1.f) / speed; // update() advances once within 1px
+}
+
 void Cart::advanceWaypoint() {
     if (waypoints.empty()) return;
-    if (current + 1 < waypoints.size()) ++current; else if (loopPath) current = 0; else return;
+    if (current + 1 < waypoints.size()) ++current; else if (loopPath && !routeCut) current = loopFrom; else return;
     if (map) {
         float ts = (float)map->tileSize();
         targetPos = { waypoints[current].x * ts + ts*0.5f, waypoints[current].y * ts + ts*0.5f };
@@ -56,7 +152,10 @@ void Cart::advanceWaypoint() {
 }
 
 void Cart::update(sf::Time dt) {
-    if (!map || waypoints.empty()) {
+    if (router && map && !stops.empty() && routedVersion != router->version()) {
+        if (!replan()) std::cerr << "Cart: route broken by rail change, some stops unreachable.\n";
+    }
+    if (!map || waypoints.empty() || held) {
         if (rider) {
             rider->setPosition(body.getPosition());
         }
@@ -2,10 +2,12 @@
 #include "Entity.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include <algorithm>
 #include "../items/Item.h"
 class TileMap;
 class ResourceManager;
 class Player; // forward declare for riding
+class RailRouter;
 
 class Cart : public Entity {
 public:
@@ -15,25 +17,41 @@ public:
     sf::FloatRect getBounds() const override { return body.getGlobalBounds(); }
     void interact(Entity* by) override;
     void setTileMap(const TileMap* m) { map = m; }
+    void setRouter(RailRouter* r) { router = r; }
     void setSpeed(float s) { speed = s; }
     void setLoop(bool v) { loopPath = v; }
     bool isLoop() const { return loopPath; } // added getter for persistence
     // add waypoint only if placed on rail and reachable from previous waypoint via continuous rail path
     void addWaypoint(const sf::Vector2u& tile);
-    void clearWaypoints() { waypoints.clear(); current = 0; }
+    // route stop: any rail tile connected to the previous stop; waypoints become the shortest rail path
+    // through all stops (closing the loop when looping) and are re-planned when the rail network changes
+    bool addStop(const sf::Vector2u& tile);
+    void clearWaypoints() { waypoints.clear(); stops.clear(); current = 0; routeCut = false; loopFrom = 0; }
+    const std::vector<sf::Vector2u>& getStops() const { return stops; }
+    // traffic signaling (RailTraffic): upcoming route tiles (0 = the one it is heading to) and a hold flag
+    bool nextTile(sf::Vector2u& out) const { return routeAhead(0, out); }
+    bool routeAhead(size_t ahead, sf::Vector2u& out) const; // false past the end of a non-looping route
+    bool atTileCenter() const;
+    float timeToTarget() const; // seconds of straight travel left before it turns at the next tile centre; <0 when not moving
+    void setHold(bool h) { held = h; }
+    bool isHeld() const { return held; }
     const std::vector<sf::Vector2u>& getWaypoints() const { return waypoints; }
     size_t currentIndex() const { return current; }
-    // inventory
+    // inventory (capacity counts item units across stacks)
     bool addItem(const ItemPtr& it) {
         if (!it) return false;
-        if (itemsCount() >= capacity) return false;
+        if (itemsCount() + std::max(1, it->stackSize) > capacity) return false;
         contents.push_back(it); return true;
     }
     ItemPtr removeOne() {
         if (contents.empty()) return nullptr;
         ItemPtr it = contents.back(); contents.pop_back(); return it;
     }
-    size_t itemsCount() const { return contents.size(); }
+    // logistics: merge up to n units of proto's kind into the cargo (returns units taken), and take up to
+    // n units of the last stack matching filter (empty = any) back out as one slice
+    unsigned loadUnits(const Item& proto, unsigned n);
+    ItemPtr unloadUnits(const std::string& filter, unsigned n);
+    size_t itemsCount() const { size_t n = 0; for (auto &it : contents) n += it ? std::max(1, it->stackSize) : 0; return n; }
     size_t maxCapacity() const { return capacity; }
     // riding API
     bool hasRider() const { return rider != nullptr; }
@@ -51,6 +69,13 @@ private:
     sf::Sprite sprite; // textured cart sprite
     sf::Vector2f targetPos;
     void advanceWaypoint();
+    RailRouter* router = nullptr;
+    std::vector<sf::Vector2u> stops;
+    uint32_t routedVersion = 0; // rail network version the waypoints were planned against
+    bool routeCut = false; // replan hit an unreachable stop: the route ends there instead of looping
+    size_t loopFrom = 0; // waypoint a looping route wraps to (past the lead-in from where replan found the cart)
+    bool held = false; // stopped by a RED/YIELD signal this tick
+    bool replan(); // expand stops into waypoints; false when some leg is unreachable or no rail leads the cart back to it
     // simple inventory
     std::vector<ItemPtr> contents;
     size_t capacity = 16;
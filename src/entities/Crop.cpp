@@ -1,13 +1,13 @@
 #include "Crop.h"
 #include "../resources/ResourceManager.h"
 #include "../world/TileMap.h"
+#include "../core/Tunables.h"
 #include <iostream>
 #include <cstdint>
 #include <algorithm>
 #include <fstream>
 #include <unordered_map>
 
-extern nlohmann::json* g_getTunablesJson();
 
 // Static registry for crop configs
 static std::unordered_map<std::string, CropConfig> g_cropConfigs;
@@ -32,13 +32,9 @@ void Crop::loadConfigs(ResourceManager& /*res*/, const std::string& path) {
                 cfg.maxQuality = cj.value("max_quality", cfg.maxQuality);
                 if (cfg.stageDurations.empty()) {
                     // fallback to evenly split from tunables or default
-                    if (auto *tj = g_getTunablesJson()) {
-                        float base = cj.value("total_time", (*tj)["farming"].value("base_growth_seconds", nlohmann::json::object()).value(cfg.id, 6.f));
-                        int stages = cj.value("stages", 3);
-                        cfg.stageDurations.assign(stages, base / std::max(1, stages));
-                    } else {
-                        cfg.stageDurations.assign(3, 2.f);
-                    }
+                    float base = cj.value("total_time", tunables().farming.growthSeconds(cfg.id, 6.f));
+                    int stages = cj.value("stages", 3);
+                    cfg.stageDurations.assign(stages, base / std::max(1, stages));
                 }
                 g_cropConfigs[cfg.id] = cfg;
             }
@@ -72,13 +68,8 @@ static float stageProgressFactor(const TileMap* map, unsigned tileX, unsigned ti
         if (mFactorLegacy < 0.3f) mFactorLegacy = 0.3f; mFactor = mFactorLegacy;
     }
     float fFactor = 0.4f + 0.6f * f;
-    if (auto *tj = g_getTunablesJson()) {
-        if ((*tj).contains("farming")) {
-            auto &fj = (*tj)["farming"];
-            mFactor *= fj.value("moisture_factor", 1.0f);
-            fFactor *= fj.value("fertility_factor", 1.0f);
-        }
-    }
+    mFactor *= tunables().farming.moistureFactor;
+    fFactor *= tunables().farming.fertilityFactor;
     return std::min(4.f, mFactor * fFactor);
 }
 
@@ -87,12 +78,7 @@ void Crop::setWindParams(float time, float amplitude, float frequency) { g_windT
 
 Crop::Crop(ResourceManager& /*resources*/, TileMap& map, const sf::Vector2f& pos, const std::string& cropId, int stages, float totalTime)
 : mapPtr(&map), id(cropId), maxStages(stages), totalGrowthTime(totalTime) {
-    if (auto *tj = g_getTunablesJson()) {
-        if ((*tj).contains("farming") && (*tj)["farming"].contains("base_growth_seconds")) {
-            auto &bg = (*tj)["farming"]["base_growth_seconds"];
-            if (bg.contains(id)) totalGrowthTime = bg[id].get<float>();
-        }
-    }
+    totalGrowthTime = tunables().farming.growthSeconds(id, totalGrowthTime);
     shape.setSize({20.f,20.f});
     shape.setOrigin(shape.getSize()/2.f);
     shape.setFillColor(sf::Color(200,180,60));
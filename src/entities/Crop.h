@@ -35,6 +35,7 @@ public:
     int yieldAmount() const { return yield; }
     bool wasHarvested() const { return harvested; }
     bool isWithered() const { return withered; }
+    bool isRipe() const { return !withered && currentStage == maxStages - 1; }
     int quality() const { return qualityTier; }
     const std::string& cropId() const { return id; }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <optional>
+#include <algorithm>
 
 class Entity {
 public:
@@ -24,6 +25,22 @@ inline bool aabbIntersect(const sf::FloatRect& a, const sf::FloatRect& b) {
              a.position.y + a.size.y <= b.position.y || b.position.y + b.size.y <= a.position.y);
 }
 
+// Segment a->b vs AABB (slab test); on hit stores entry fraction (0..1, 0 when a starts inside) in t
+inline bool segmentIntersectsRect(const sf::Vector2f& a, const sf::Vector2f& b, const sf::FloatRect& r, float* t = nullptr) {
+    float t0 = 0.f, t1 = 1.f;
+    float p[2] = {a.x, a.y}, d[2] = {b.x - a.x, b.y - a.y};
+    float lo[2] = {r.position.x, r.position.y}, hi[2] = {r.position.x + r.size.x, r.position.y + r.size.y};
+    for (int i = 0; i < 2; ++i) {
+        if (d[i] == 0.f) { if (p[i] < lo[i] || p[i] > hi[i]) return false; continue; }
+        float e0 = (lo[i] - p[i]) / d[i], e1 = (hi[i] - p[i]) / d[i];
+        if (e0 > e1) std::swap(e0, e1);
+        t0 = std::max(t0, e0); t1 = std::min(t1, e1);
+        if (t0 > t1) return false;
+    }
+    if (t) *t = t0;
+    return true;
+}
+
 // Sweep test along one axis: returns corrected delta so AABB doesn't penetrate obstacle bounds
 inline float resolveAxis(float posMin, float posMax, float move, float blockMin, float blockMax) {
     if (move > 0.f) {
@@ -0,0 +1,24 @@
+#include "EntityWorld.h"
+#include <algorithm>
+
+void EntityWorld::sweep() {
+    if (pending.empty()) return;
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+    auto gone = [&](const Entity* e){ return std::binary_search(pending.begin(), pending.end(), e); };
+    for (Entity* e : pending) grid.remove(e);
+    // typed lists first (they hold raw pointers into the owners below)
+    std::apply([&](auto&... l){ ((l.erase(std::remove_if(l.begin(), l.end(), [&](auto* e){ return gone(e); }), l.end())), ...); }, lists);
+    size_t out = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (gone(entities[i].get())) continue;
+        if (out != i) { entities[out] = std::move(entities[i]); kinds[out] = kinds[i]; }
+        ++out;
+    }
+    entities.resize(out); kinds.resize(out);
+    pending.clear();
+}
+
+void EntityWorld::syncSpatial() {
+    for (auto &e : entities) grid.update(e.get(), e->getBounds());
+}
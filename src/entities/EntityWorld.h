@@ -0,0 +1,66 @@
+#pragma once
+#include "Entity.h"
+#include "NPC.h"
+#include "HostileNPC.h"
+#include "Rail.h"
+#include "ItemEntity.h"
+#include "../world/SpatialHash.h"
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+// Owns the world entities (in spawn order, for drawing / generic interaction) plus one dense pointer list
+// per registered type, filled at spawn from the static type, so systems walk only their own kind without
+// RTTI. A type lands in every list whose class it derives from (a HostileNPC is also an NPC).
+// despawn() only queues; sweep() drops queued entities from every list at once, so lists may be
+// iterated (and spawned into) while entities are being despawned. A spatial hash over every entity's
+// bounds answers proximity queries per type; call syncSpatial() after entities moved.
+class EntityWorld {
+public:
+    template<class T, class... Args> T* spawn(Args&&... args) { return add(std::make_unique<T>(std::forward<Args>(args)...)); }
+    template<class T> T* add(std::unique_ptr<T> e) {
+        T* raw = e.get(); uint8_t mask = 0;
+        registerAs<T>(raw, mask, std::make_index_sequence<std::tuple_size<Lists>::value>{});
+        grid.insert(raw, raw->getBounds(), mask | AnyMask);
+        entities.push_back(std::move(e)); kinds.push_back(mask);
+        return raw;
+    }
+    void despawn(Entity* e) { if (e) pending.push_back(e); }
+    void sweep(); // remove everything despawned since the last sweep
+
+    template<class T> const std::vector<T*>& list() const { return std::get<std::vector<T*>>(lists); }
+    const std::vector<std::unique_ptr<Entity>>& all() const { return entities; }
+    template<class T> bool is(size_t i) const { return (kinds[i] >> index<T>()) & 1u; } // i indexes all()
+    size_t size() const { return entities.size(); }
+
+    // proximity queries, T = Entity for any type (results in no fixed order)
+    void syncSpatial(); // re-bucket every entity by its current bounds
+    template<class T> void queryRect(const sf::FloatRect& r, std::vector<T*>& out) const { grid.queryRect(r, maskOf<T>(), found); cast(out); }
+    template<class T> void queryRadius(sf::Vector2f c, float radius, std::vector<T*>& out) const { grid.queryRadius(c, radius, maskOf<T>(), found); cast(out); }
+    template<class T> T* nearest(sf::Vector2f p, float maxDist) const { return static_cast<T*>(grid.nearest(p, maxDist, maskOf<T>())); }
+
+private:
+    using Lists = std::tuple<std::vector<NPC*>, std::vector<HostileNPC*>, std::vector<Rail*>, std::vector<ItemEntity*>>;
+    template<class T, size_t I = 0> static constexpr size_t index() {
+        if constexpr (std::is_same<std::tuple_element_t<I, Lists>, std::vector<T*>>::value) return I; else return index<T, I + 1>();
+    }
+    static constexpr uint32_t AnyMask = 1u << 31;
+    template<class T> static constexpr uint32_t maskOf() { if constexpr (std::is_same<T, Entity>::value) return AnyMask; else return 1u << index<T>(); }
+    template<class T> void cast(std::vector<T*>& out) const { out.clear(); for (Entity* e : found) out.push_back(static_cast<T*>(e)); } // the mask guarantees T
+    template<class T, size_t... I> void registerAs(T* e, uint8_t& mask, std::index_sequence<I...>) {
+        (registerOne<T, I>(e, mask), ...);
+    }
+    template<class T, size_t I> void registerOne(T* e, uint8_t& mask) {
+        using U = typename std::tuple_element_t<I, Lists>::value_type; // U is a pointer type
+        if constexpr (std::is_base_of<std::remove_pointer_t<U>, T>::value) { std::get<I>(lists).push_back(e); mask |= uint8_t(1u << I); }
+    }
+
+    std::vector<std::unique_ptr<Entity>> entities;
+    std::vector<uint8_t> kinds; // per entity: bit I set when it sits in list I
+    Lists lists;
+    std::vector<Entity*> pending;
+    SpatialHash grid{64.f};
+    mutable std::vector<Entity*> found; // query scratch
+};
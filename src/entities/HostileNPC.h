@@ -2,27 +2,17 @@
 #include "NPC.h"
 #include <SFML/Graphics.hpp>
 #include <iostream>
-#include <nlohmann/json.hpp>
-extern nlohmann::json* g_getTunablesJson();
+#include "../core/Tunables.h"
 class Player; // forward
+class FlowField;
 
 class HostileNPC : public NPC {
 public:
     enum Type { Grunt, Tank };
     HostileNPC(const sf::Vector2f& pos, Player* target, Type type = Grunt)
     : NPC(pos), playerTarget(target), variant(type) {
-        if (auto *tj = g_getTunablesJson()) {
-            if ((*tj).contains("hostile")) {
-                auto &hroot = (*tj)["hostile"];
-                const char* key = (variant==Tank? "tank" : "grunt");
-                if (hroot.contains(key)) {
-                    auto &gj = hroot[key];
-                    if (gj.contains("speed")) speed = gj["speed"].get<float>();
-                    if (gj.contains("health")) { maxHealth = gj["health"].get<float>(); health = maxHealth; }
-                    if (gj.contains("contact_damage")) contactDamage = gj["contact_damage"].get<float>();
-                }
-            }
-        }
+        const Tunables::Hostile& t = variant==Tank ? tunables().hostile.tank : tunables().hostile.grunt;
+        speed = t.speed; maxHealth = health = t.health; contactDamage = t.contactDamage;
         // tank visual tweak
         if (variant==Tank) { shape.setSize({40.f,40.f}); shape.setOrigin(shape.getSize()/2.f); shape.setFillColor(sf::Color(180,70,70)); }
     }
@@ -33,13 +23,14 @@ public:
     void setHealth(float h) { health = std::max(0.f, std::min(maxHealth, h)); }
     void nudge(const sf::Vector2f& delta); // apply external displacement (knockback)
     void setTileMap(const TileMap* m) { tileMap = m; NPC::setTileMap(m); }
+    void setFlowField(const FlowField* f) { flowField = f; } // shared chase field toward the player
 
     // Health interface
     bool hasHealth() const override { return true; }
     float getHealth() const override { return health; }
     float getMaxHealth() const override { return maxHealth; }
     bool isDead() const override { return health <= 0.f; }
-    void onDamaged(float) override { flashTimer = 0.15f; rageTimer = rageDuration; }
+    void onDamaged(float) override { flashTimer = 0.15f; rageTimer = tunables().hostile.grunt.rageDuration; }
 
     // Variant accessor for persistence
     Type getType() const { return variant; }
@@ -55,11 +46,13 @@ private:
     float contactDamage = 8.f;
     float flashTimer = 0.f;
 
-    // Rage mechanics
+    // Rage mechanics (duration / speed multiplier are the grunt tunables for every variant, read live)
     float rageTimer = 0.f;
-    float rageDuration = 0.f;
-    float rageSpeedMult = 1.f;
     const TileMap* tileMap = nullptr; // for knockback collision tests
+    // line of sight to the player (tile raycast), refreshed a few times per second
+    bool seesPlayer = true;
+    float losTimer = 0.f;
+    const FlowField* flowField = nullptr; // steering around walls when the player is out of sight
 
     // Loot stub (phase 2): simple drop chances
     float dropFiberChance = 0.6f; // 60% chance
@@ -1,24 +1,14 @@
 #include "Player.h"
 #include "ItemEntity.h"
 #include <algorithm>
-#include <nlohmann/json.hpp>
 #include "../resources/ResourceManager.h"
-extern nlohmann::json* g_getTunablesJson();
+#include "../core/Tunables.h"
 
 Player::Player(InputManager& inputMgr, ResourceManager& res)
 : speed(200.f), input(inputMgr), inv(32), health(100.f), maxHealth(100.f), regenRate(5.f), regenDelay(2.f), sinceDamage(0.f), invulnTimeRemaining(0.f), sprite(res.texture("assets/textures/entities/player_idle.png"))
 {
-    // apply tunables if present
-    if (auto *tj = g_getTunablesJson()) {
-        if ((*tj).contains("player")) {
-            auto &pj = (*tj)["player"];
-            if (pj.contains("speed")) speed = pj["speed"].get<float>();
-            if (pj.contains("regen_rate")) regenRate = pj["regen_rate"].get<float>();
-            if (pj.contains("regen_delay")) regenDelay = pj["regen_delay"].get<float>();
-            if (pj.contains("base_damage")) damageBase = pj["base_damage"].get<float>();
-            if (pj.contains("regen_curve_exponent")) regenCurveExponent = pj["regen_curve_exponent"].get<float>();
-        }
-    }
+    applyTunables();
+    damageBase = tunables().player.baseDamage; // saved with the game, so only taken at spawn
     shape.setSize({32.f, 32.f});
     shape.setFillColor(sf::Color::Green);
     shape.setOrigin(shape.getSize() / 2.f);
@@ -31,6 +21,11 @@ Player::Player(InputManager& inputMgr, ResourceManager& res)
     sprite.setPosition(shape.getPosition());
 }
 
+void Player::applyTunables() {
+    const Tunables::Player& t = tunables().player;
+    speed = t.speed; regenRate = t.regenRate; regenDelay = t.regenDelay; regenCurveExponent = t.regenCurveExponent;
+}
+
 void Player::update(sf::Time dt) {
     vel = {0.f, 0.f};
     // Action-based movement
@@ -49,6 +49,7 @@ public:
     void resetLifeStats() { damageAccumulatedThisLife = 0.f; }
     float baseDamage() const { return damageBase; }
     void setBaseDamage(float v) { damageBase = v; }
+    void applyTunables(); // movement speed + regen from tunables() (spawn and live reload)
     void onDamaged(float) override { damageFlashTimer = 0.2f; /* placeholder for screen flash */ }
 
     bool hasWateringTool() const; // inventory search for tool_wateringcan
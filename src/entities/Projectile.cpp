@@ -1,4 +1,5 @@
 #include "Projectile.h"
+#include "../world/TileMap.h"
 #include <algorithm>
 
 Projectile::Projectile(const sf::Vector2f& pos, const sf::Vector2f& vel, float speed, float life, float dmg, float knock)
@@ -7,12 +8,21 @@ Projectile::Projectile(const sf::Vector2f& pos, const sf::Vector2f& vel, float s
     shape.setOrigin({4.f,4.f});
     shape.setFillColor(sf::Color::Yellow);
     shape.setPosition(pos);
+    prevPos = pos;
 }
 
 void Projectile::update(sf::Time dt) {
     float s = dt.asSeconds();
-    shape.move(velocity * s);
+    prevPos = shape.getPosition();
     lifetime -= s;
+    if (tileMap) {
+        // swept circle so fast shots can't tunnel through walls; stop at the contact point
+        auto hit = tileMap->sweepCircle(prevPos, prevPos + velocity * s, shape.getRadius());
+        shape.setPosition(hit.point);
+        if (hit.hit) kill();
+        return;
+    }
+    shape.move(velocity * s);
 }
 
 void Projectile::draw(sf::RenderWindow& win) { win.draw(shape); }
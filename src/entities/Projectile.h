@@ -1,6 +1,7 @@
 #pragma once
 #include "Entity.h"
 #include <SFML/Graphics.hpp>
+class TileMap;
 
 class Projectile : public Entity {
 public:
@@ -13,6 +14,10 @@ public:
     float remainingLife() const { return lifetime; }
     void kill() { lifetime = 0.f; }
     const sf::Vector2f& getVelocity() const { return velocity; }
+    sf::Vector2f position() const { return shape.getPosition(); }
+    sf::Vector2f previousPosition() const { return prevPos; } // start of this tick's travel (for swept hit tests)
+    float radius() const { return shape.getRadius(); }
+    void setTileMap(const TileMap* m) { tileMap = m; } // enables continuous collision against Solid tiles
     float getKnockback() const { return knockback; }
     float damage = 3.f;
     float knockback = 0.f; // displacement magnitude applied to target on hit
@@ -21,4 +26,6 @@ private:
     sf::Vector2f velocity;
     float speedVal;
     float lifetime;
+    sf::Vector2f prevPos;
+    const TileMap* tileMap = nullptr;
 };
\ No newline at end of file
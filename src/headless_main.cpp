@@ -1,4 +1,5 @@
 #include "core/Game.h"
+#include "bench/Benchmarks.h"
 #include <iostream>
 #include <nlohmann/json.hpp>
 
@@ -9,6 +10,7 @@ int main(int argc, char** argv) {
     for (int i=1;i<argc;++i) {
         std::string a = argv[i];
         if (a == "--ticks" && i+1<argc) { ticks = std::atoi(argv[++i]); }
+        if (a == "--bench" && i+1<argc) { std::cout << runBenchmark(argv[++i]).dump(2) << "\n"; return 0; }
     }
     if (!headless) { Game g; g.run(); return 0; }
     std::cerr << "Headless mode executing "<<ticks<<" ticks.\n";
@@ -27,8 +27,10 @@
 #include <random> // added for mt19937 and uniform_real_distribution
 #include "../entities/Cart.h" // cart integration
 #include "../systems/Quest.h"
+#include "../systems/FastForward.h"
 #include <cctype>
 #include "../systems/SoundManager.h" // ensure complete type for game.sound() usage
+#include "../core/Tunables.h"
 
 // NOTE: Several member function definitions went missing after earlier patching, causing
 // undefined symbol linker errors. We restore lightweight implementations here matching
@@ -41,25 +43,29 @@ static sf::Vector2f rect_center(const sf::FloatRect& r) {
     return { r.position.x + r.size.x * 0.5f, r.position.y + r.size.y * 0.5f };
 }
 
+// world-space rect covered by a view (rotation ignored), grown by margin on every side
+static sf::FloatRect view_rect(const sf::View& v, float margin = 0.f) {
+    sf::Vector2f half = v.getSize() * 0.5f + sf::Vector2f{margin, margin};
+    return { v.getCenter() - half, half * 2.f };
+}
+
 // deterministic RNG for hostile variant spawning
 static std::mt19937 g_hostileRng(1337u);
 static std::uniform_real_distribution<float> g_hostileDist(0.f,1.f);
 static float rand01() { return g_hostileDist(g_hostileRng); }
 
+// world size in tiles from tunables ("world": { "width", "height" }); storage is chunked so large maps are cheap
 PlayState::PlayState(Game& g)
-: game(g), view(g.getWindow().getDefaultView()), map(50, 30, 32)
+: game(g), view(g.getWindow().getDefaultView()), map(tunables().world.width, tunables().world.height, 32)
 {
     // Load crop configs before creating crops
     Crop::loadConfigs(game.resources(), "data/crops.json");
     map.generateTestMap();
     std::cerr << "[PlayState] Setting rail texture path=assets/textures/entities/tiles/rail.png\n";
     map.setRailTexture(game.resources(), "assets/textures/entities/tiles/rail.png");
-    if (auto *tj = g_getTunablesJson()) {
-        if ((*tj).contains("soil")) {
-            auto &sj = (*tj)["soil"];
-            map.setSoilTunables(sj.value("moisture_target",0.3f), sj.value("moisture_decay_per_sec",0.02f), sj.value("fertility_target",0.5f), sj.value("fertility_regen_per_sec",0.005f));
-        }
-    }
+    std::string soilMode = tunables().soil.mode;
+    if (soilMode == "sweep") map.setSoilMode(TileMap::SoilMode::Sweep);
+    else if (soilMode == "lazy") map.setSoilMode(TileMap::SoilMode::Lazy);
 
     // try to set a font for dialog (user should place Arial at assets/fonts/arial.ttf)
     try {
@@ -75,42 +81,45 @@ PlayState::PlayState(Game& g)
         player->inventory().addItem(std::make_shared<Item>("seed_wheat", "Wheat Seed", "Seed", 1));
     }
 
+    // logistics stations (tiles assigned in cart route mode): the loader feeds carts from the player's wheat seeds
+    // and the unloader hands cargo back to the player, so a cart running between them is a round trip, not a sink
+    {
+        loaderStation = logistics.addStation(Logistics::Kind::Loader, loaderTile, tunables().logistics.loaderItemsPerSec, &player->inventory());
+        logistics.station(loaderStation)->filter = "seed_wheat";
+        unloaderStation = logistics.addStation(Logistics::Kind::Unloader, unloaderTile, tunables().logistics.unloaderItemsPerSec, &player->inventory());
+    }
+    applyTunables();
+
     // now that player exists, create inventoryUI with player's inventory reference
     inventoryUI = std::make_unique<InventoryUI>(game.resources(), player->inventory());
 
-    entities.push_back(std::make_unique<NPC>(sf::Vector2f(700.f, 380.f)));
+    entities.spawn<NPC>(sf::Vector2f(700.f, 380.f));
     auto sample = std::make_shared<Item>("apple_01", "Apple", "A juicy apple", 1);
-    entities.push_back(std::make_unique<ItemEntity>(sample, sf::Vector2f(600.f, 380.f)));
+    entities.spawn<ItemEntity>(sample, sf::Vector2f(600.f, 380.f));
 
     // spawn crops
-    entities.push_back(std::make_unique<Crop>(game.resources(), map, sf::Vector2f(300.f, 300.f), "wheat", 3, 5.f));
-    entities.push_back(std::make_unique<Crop>(game.resources(), map, sf::Vector2f(340.f, 300.f), "wheat", 3, 7.f));
+    crops.plant(300u / map.tileSize(), 300u / map.tileSize(), "wheat", 3, 5.f);
+    crops.plant(340u / map.tileSize(), 300u / map.tileSize(), "wheat", 3, 7.f);
 
     // add sample rail pieces in a small area
-    entities.push_back(std::make_unique<Rail>(game.resources(), sf::Vector2f(200.f, 200.f), map.tileSize()));
-    entities.push_back(std::make_unique<Rail>(game.resources(), sf::Vector2f(232.f, 200.f), map.tileSize()));
-    entities.push_back(std::make_unique<Rail>(game.resources(), sf::Vector2f(264.f, 200.f), map.tileSize()));
+    entities.spawn<Rail>(game.resources(), sf::Vector2f(200.f, 200.f), map.tileSize());
+    entities.spawn<Rail>(game.resources(), sf::Vector2f(232.f, 200.f), map.tileSize());
+    entities.spawn<Rail>(game.resources(), sf::Vector2f(264.f, 200.f), map.tileSize());
 
     // create a test altar
-    entities.push_back(std::make_unique<Altar>(game.resources(), sf::Vector2f(900.f, 600.f)));
-    if (auto altar = dynamic_cast<Altar*>(entities.back().get())) {
-        altar->setRequiredItems({"dongle_mysterious"});
-    }
+    entities.spawn<Altar>(game.resources(), sf::Vector2f(900.f, 600.f))->setRequiredItems({"dongle_mysterious"});
 
     // spawn a hostile NPC targeting the player
-    entities.push_back(std::make_unique<HostileNPC>(sf::Vector2f(400.f, 300.f), player.get()));
-    if (auto h = dynamic_cast<HostileNPC*>(entities.back().get())) h->setTileMap(&map);
+    spawnHostile(sf::Vector2f(400.f, 300.f));
 
     // add a hidden location test marker at tile (10,10)
     unsigned hx = 10, hy = 10;
     float tsf = (float)map.tileSize();
     sf::Vector2f hpos((float)hx * tsf + tsf * 0.5f, (float)hy * tsf + tsf * 0.5f);
-    entities.push_back(std::make_unique<HiddenLocation>(map, hx, hy));
+    entities.spawn<HiddenLocation>(map, hx, hy);
 
     // ensure NPCs get a pointer to the world TileMap for simple collision checks
-    for (auto &e : entities) {
-        if (auto npc = dynamic_cast<NPC*>(e.get())) npc->setTileMap(&map);
-    }
+    for (auto *npc : entities.list<NPC>()) npc->setTileMap(&map);
 
     // initialize rail tool
     railTool = std::make_unique<RailTool>(game.resources(), map);
@@ -160,6 +169,7 @@ PlayState::PlayState(Game& g)
     {
         auto cart = std::make_unique<Cart>(game.resources(), sf::Vector2f(200.f + map.tileSize()*0.5f, 200.f + map.tileSize()*0.5f), map.tileSize());
         cart->setTileMap(&map);
+        cart->setRouter(&railRouter);
         // waypoints across the three sample rails placed earlier (x=200,232,264)
         cart->addWaypoint({ (unsigned)(200 / map.tileSize()), (unsigned)(200 / map.tileSize()) });
         cart->addWaypoint({ (unsigned)(232 / map.tileSize()), (unsigned)(200 / map.tileSize()) });
@@ -239,16 +249,19 @@ void PlayState::loadGame(const std::string& path) {
 
 // ---------------- Rails / Logistics ----------------
 void PlayState::syncRailsWithMap() {
-    // Ensure a Rail entity exists for each rail tile (basic sync; avoids duplicates by AABB match)
+    // Ensure a Rail entity exists for each rail tile (walks the rail network, not the whole map; duplicates matched by position)
     unsigned ts = map.tileSize();
-    auto isRailEntityAt = [&](unsigned tx, unsigned ty){
-    sf::FloatRect target({static_cast<float>(tx*ts),static_cast<float>(ty*ts)},{(float)ts,(float)ts});
-        for (auto &e : entities) if (auto r = dynamic_cast<Rail*>(e.get())) { if (r->getBounds().position == target.position) return true; }
-        return false;
-    };
-    for (unsigned y=0; y<map.height(); ++y) for (unsigned x=0; x<map.width(); ++x) if (map.isTileRail(x,y) && !isRailEntityAt(x,y)) {
-        entities.push_back(std::make_unique<Rail>(game.resources(), sf::Vector2f(x*ts,y*ts), ts));
-    }
+    std::vector<sf::Vector2f> have;
+    for (auto *r : entities.list<Rail>()) have.push_back(r->getBounds().position);
+    auto before = [](sf::Vector2f a, sf::Vector2f b){ return a.y < b.y || (a.y == b.y && a.x < b.x); };
+    std::sort(have.begin(), have.end(), before);
+    std::vector<sf::Vector2u> missing;
+    map.rails().forEachTile([&](unsigned x, unsigned y){
+        sf::Vector2f p(static_cast<float>(x*ts), static_cast<float>(y*ts));
+        auto it = std::lower_bound(have.begin(), have.end(), p, before);
+        if (it == have.end() || *it != p) missing.push_back({x,y});
+    });
+    for (auto t : missing) entities.spawn<Rail>(game.resources(), sf::Vector2f(t.x*ts,t.y*ts), ts);
 }
 
 // ---------------- Projectiles ----------------
@@ -260,8 +273,9 @@ void PlayState::spawnProjectile(std::unique_ptr<Entity> p) {
 HostileNPC* PlayState::spawnHostile(const sf::Vector2f& pos) {
     auto h = std::make_unique<HostileNPC>(pos, player.get());
     h->setTileMap(&map);
+    h->setFlowField(&hostileFlow);
     HostileNPC* raw = h.get();
-    entities.push_back(std::move(h));
+    entities.add(std::move(h));
     return raw;
 }
 
@@ -280,12 +294,7 @@ void PlayState::processHoldToHarvest(sf::Time dt) {
         for (int dx=-harvestRadius; dx<=harvestRadius; ++dx) {
             int tx = (int)px + dx; int ty = (int)py + dy;
             if (tx<0||ty<0||tx>=(int)map.width()||ty>=(int)map.height()) continue;
-            for (auto &e : entities) if (auto c = dynamic_cast<Crop*>(e.get())) {
-                sf::FloatRect b = c->getBounds();
-                unsigned cx = (unsigned)std::floor((b.position.x + b.size.x*0.5f)/ts);
-                unsigned cy = (unsigned)std::floor((b.position.y + b.size.y*0.5f)/ts);
-                if (cx==(unsigned)tx && cy==(unsigned)ty) { c->interact(player.get()); return; }
-            }
+            if (crops.interact(crops.cropAt((unsigned)tx, (unsigned)ty))) return;
         }
     }
 }
@@ -403,47 +412,33 @@ void PlayState::handleEvent(const sf::Event& /*ev*/) {
 }
 
 bool PlayState::tryMovePlayer(const sf::Vector2f& desired) {
-    // Improved AABB vs tile collision using axis resolution and resolveAxis helper
+    // axis-separated sweep against the tile map's solid bitmap
     if (!player) return false;
-    sf::FloatRect pb = player->getBounds();
-    auto sweepAxis = [&](float& move, bool horizontal){
-        if (move == 0.f) return;
-        sf::FloatRect b = player->getBounds();
-        // Expand query region to cover movement path
-        float minX = b.position.x + (horizontal? std::min(0.f, move) : 0.f);
-        float maxX = b.position.x + b.size.x + (horizontal? std::max(0.f, move) : 0.f);
-        float minY = b.position.y + (!horizontal? std::min(0.f, move) : 0.f);
-        float maxY = b.position.y + b.size.y + (!horizontal? std::max(0.f, move) : 0.f);
-        unsigned ts = map.tileSize();
-        int tx0 = std::max(0, (int)std::floor(minX / ts));
-        int tx1 = std::min((int)map.width()-1, (int)std::floor((maxX-0.0001f) / ts));
-        int ty0 = std::max(0, (int)std::floor(minY / ts));
-        int ty1 = std::min((int)map.height()-1, (int)std::floor((maxY-0.0001f) / ts));
-        float posMin = horizontal? b.position.x : b.position.y;
-        float posMax = horizontal? (b.position.x + b.size.x) : (b.position.y + b.size.y);
-        for (int ty = ty0; ty <= ty1; ++ty) {
-            for (int tx = tx0; tx <= tx1; ++tx) {
-                if (!map.isTileSolid(tx,ty)) continue;
-                sf::FloatRect tileRect({(float)tx*ts,(float)ty*ts},{(float)ts,(float)ts});
-                float blockMin = horizontal? tileRect.position.x : tileRect.position.y;
-                float blockMax = horizontal? (tileRect.position.x + tileRect.size.x) : (tileRect.position.y + tileRect.size.y);
-                float adjusted = resolveAxis(posMin, posMax, move, blockMin, blockMax);
-                if (std::abs(adjusted) < std::abs(move)) move = adjusted; // clamped
-                if (move == 0.f) return; // fully blocked
-            }
-        }
-    };
-    float mx = desired.x; float my = desired.y;
-    sweepAxis(mx, true);
+    float mx = map.sweepAxis(player->getBounds(), desired.x, true);
     player->applyMove({mx,0.f});
-    sweepAxis(my, false);
+    float my = map.sweepAxis(player->getBounds(), desired.y, false);
     player->applyMove({0.f,my});
     return true;
 }
 
+// Push the values systems copy into their own state; runs at construction and whenever Game swapped in
+// a reloaded tunables file. Spawn-time stats (hostile health, world size, base damage) only affect new spawns.
+void PlayState::applyTunables() {
+    const Tunables& t = tunables();
+    tunablesVersion = t.version;
+    map.setSoilTunables(t.soil.moistureTarget, t.soil.moistureDecayPerSec, t.soil.fertilityTarget, t.soil.fertilityRegenPerSec);
+    hostileFlow.setRadius(t.hostile.flowRadius);
+    if (auto *st = logistics.station(loaderStation)) st->itemsPerSec = t.logistics.loaderItemsPerSec;
+    if (auto *st = logistics.station(unloaderStation)) st->itemsPerSec = t.logistics.unloaderItemsPerSec;
+    logisticsBatch = std::max(1.f/60.f, t.logistics.batchSeconds);
+    lightmap.setDownscale(t.lighting.lightmapDownscale);
+    if (player) player->applyTunables();
+}
+
 void PlayState::update(sf::Time dt) {
     // Quit
     if (game.input().actionPressed("Quit")) { game.getWindow().close(); return; }
+    if (tunablesVersion != tunables().version) applyTunables();
     hudTime += dt.asSeconds();
 
     // Dialog handling (pauses world unless hidden realm active)
@@ -516,9 +511,10 @@ void PlayState::update(sf::Time dt) {
         if (dir.x==0 && dir.y==0) dir = {1.f,0.f};
         float len = std::hypot(dir.x, dir.y); if (len>0.f) dir /= len;
         float dmg = player->baseDamage();
-        float projSpeed = 300.f, projKnock = 0.f, projLife = 2.f;
-        if (auto *tj = g_getTunablesJson()) if ((*tj).contains("projectile")) { auto &pj = (*tj)["projectile"]; if (pj.contains("speed")) projSpeed = pj["speed"].get<float>(); if (pj.contains("knockback")) projKnock = pj["knockback"].get<float>(); if (pj.contains("lifetime")) projLife = pj["lifetime"].get<float>(); }
-        spawnProjectile(std::make_unique<Projectile>(player->position(), dir * projSpeed, projSpeed, projLife, dmg, projKnock));
+        const Tunables::Projectile& pt = tunables().projectile;
+        auto proj = std::make_unique<Projectile>(player->position(), dir * pt.speed, pt.speed, pt.lifetime, dmg, pt.knockback);
+        proj->setTileMap(&map);
+        spawnProjectile(std::move(proj));
         timeSinceLastProjectile = 0.f;
     }
 
@@ -542,7 +538,8 @@ void PlayState::update(sf::Time dt) {
     // Magnet pickup
     {
         float ts = (float)map.tileSize(); float radiusPx = magnetRadius * ts; float radiusSq = radiusPx*radiusPx; sf::Vector2f pp = player->position();
-        for (auto &e : entities) if (auto itemEnt = dynamic_cast<ItemEntity*>(e.get())) if (!itemEnt->collected()) {
+        std::vector<ItemEntity*> nearItems; entities.queryRadius(pp, radiusPx, nearItems);
+        for (auto *itemEnt : nearItems) if (!itemEnt->collected()) {
             sf::FloatRect b = itemEnt->getBounds(); sf::Vector2f center{b.position.x + b.size.x*0.5f, b.position.y + b.size.y*0.5f}; sf::Vector2f d = pp - center; float distSq = d.x*d.x + d.y*d.y; if (distSq <= radiusSq) {
                 float dist = std::sqrt(distSq); if (dist < 28.f) { itemEnt->interact(player.get()); } else itemEnt->startMagnet();
             }
@@ -558,45 +555,71 @@ void PlayState::update(sf::Time dt) {
 
     // Explore fog
     {
-        float ts = (float)map.tileSize(); sf::Vector2f p = player->position(); int px=(int)std::floor(p.x/ts), py=(int)std::floor(p.y/ts); int radius=6; for(int dy=-radius;dy<=radius;++dy) for(int dx=-radius;dx<=radius;++dx){ if(dx*dx+dy*dy>radius*radius) continue; map.markExplored((unsigned)(px+dx),(unsigned)(py+dy)); }
+        float ts = (float)map.tileSize(); sf::Vector2f p = player->position(); sf::Vector2i pt((int)std::floor(p.x/ts), (int)std::floor(p.y/ts));
+        if (pt != lastRevealTile) { lastRevealTile = pt; map.revealDisc(pt.x, pt.y, 6); } // the disc only grows when the player crosses a tile
     }
 
     // Threat / hostile spawning
     if (hostileSpawningEnabled) {
-        float ds = dt.asSeconds(); sf::Vector2f cur = player->position(); float moveDist = std::hypot(cur.x-lastPlayerPos.x, cur.y-lastPlayerPos.y); lastPlayerPos = cur; threatLevel += ds*0.25f + moveDist*0.002f; if (threatLevel>50.f) threatLevel=50.f; hostileSpawnInterval = hostileSpawnIntervalBase * std::max(0.25f, 1.f - threatLevel * threatToIntervalFactor); maxHostiles = std::min(14, 5 + (int)std::floor(threatLevel * threatToMaxHostilesFactor * 5.f)); tankSpawnChance = std::min(0.5f, threatLevel*0.01f); hostileSpawnTimer += ds; int active=0; for(auto &e:entities) if (dynamic_cast<HostileNPC*>(e.get())) ++active; if (hostileSpawnTimer>=hostileSpawnInterval && active<maxHostiles){ hostileSpawnTimer=0.f; std::vector<sf::Vector2f> cand; for(auto &pt:hostileSpawnPoints){ sf::Vector2f d=pt-cur; if(d.x*d.x+d.y*d.y>=minSpawnDistance*minSpawnDistance) cand.push_back(pt);} if(!cand.empty()){ float r=rand01(); sf::Vector2f sp=cand[(size_t)(r*cand.size())%cand.size()]; spawnHostile(sp);} }
+        float ds = dt.asSeconds(); sf::Vector2f cur = player->position(); float moveDist = std::hypot(cur.x-lastPlayerPos.x, cur.y-lastPlayerPos.y); lastPlayerPos = cur; threatLevel += ds*0.25f + moveDist*0.002f; if (threatLevel>50.f) threatLevel=50.f; hostileSpawnInterval = hostileSpawnIntervalBase * std::max(0.25f, 1.f - threatLevel * threatToIntervalFactor); maxHostiles = std::min(14, 5 + (int)std::floor(threatLevel * threatToMaxHostilesFactor * 5.f)); tankSpawnChance = std::min(0.5f, threatLevel*0.01f); hostileSpawnTimer += ds; int active=(int)entities.list<HostileNPC>().size(); if (hostileSpawnTimer>=hostileSpawnInterval && active<maxHostiles){ hostileSpawnTimer=0.f; std::vector<sf::Vector2f> cand; for(auto &pt:hostileSpawnPoints){ sf::Vector2f d=pt-cur; if(d.x*d.x+d.y*d.y>=minSpawnDistance*minSpawnDistance) cand.push_back(pt);} if(!cand.empty()){ float r=rand01(); sf::Vector2f sp=cand[(size_t)(r*cand.size())%cand.size()]; spawnHostile(sp);} }
     }
 
+    // chase field follows the player tile; rebuilt only on tile change or solidity change
+    hostileFlow.setGoal(player->position());
+    hostileFlow.update();
+
     // Update entities / carts / projectiles & collisions
-    for (auto &e : entities) e->update(dt);
+    for (auto &e : entities.all()) e->update(dt);
+    entities.syncSpatial();
+    crops.update(dt);
+    railTraffic.update(carts, dt);
     for (auto &c : carts) c->update(dt);
+    logisticsTimer += dt.asSeconds();
+    while (logisticsTimer >= logisticsBatch) {
+        logisticsTimer -= logisticsBatch;
+        unsigned delivered = logistics.update(carts, sf::seconds(logisticsBatch), map.tileSize()).second;
+        if (delivered) { cartItemsMoved += (int)delivered; incrementQuestProgress("move_item_via_cart", (int)delivered); }
+    }
     for (auto &p : worldProjectiles) p->update(dt);
-    // Projectile collisions
+    // Projectile collisions (candidates from the spatial hash around each shot's swept box)
+    std::vector<HostileNPC*> nearHostiles;
     for (auto it = worldProjectiles.begin(); it!=worldProjectiles.end();) {
         bool remove=false; if (auto proj = dynamic_cast<Projectile*>(it->get())) {
-            if (proj->expired()) remove=true; else {
-                sf::FloatRect pb = proj->getBounds();
-                for (auto &e : entities) if (auto hostile = dynamic_cast<HostileNPC*>(e.get())) {
-                    sf::FloatRect hb = hostile->getBounds(); bool overlap = !(pb.position.x+pb.size.x < hb.position.x || hb.position.x+hb.size.x < pb.position.x || pb.position.y+pb.size.y < hb.position.y || hb.position.y+hb.size.y < pb.position.y);
-                    if (overlap) { hostile->takeDamage(proj->damage); try { auto &f = game.resources().font("assets/fonts/arial.ttf"); sf::Text dmgTxt(f,std::to_string((int)proj->damage),14u); dmgTxt.setFillColor(sf::Color::White); dmgTxt.setPosition({hb.position.x+hb.size.x*0.5f, hb.position.y-10.f}); combatTexts.push_back({dmgTxt,{0.f,-30.f},0.9f}); } catch(...) {} proj->kill(); remove=true; break; }
-                }
+            // swept test over this tick's travel (a shot stopped by a wall can still hit a hostile in front of it)
+            sf::Vector2f a = proj->previousPosition(), b = proj->position(); float r = proj->radius();
+            HostileNPC* target = nullptr; float bestT = 2.f;
+            sf::FloatRect swept({std::min(a.x,b.x) - r, std::min(a.y,b.y) - r}, {std::abs(b.x-a.x) + 2.f*r, std::abs(b.y-a.y) + 2.f*r});
+            entities.queryRect(swept, nearHostiles);
+            for (auto *hostile : nearHostiles) {
+                sf::FloatRect hb = hostile->getBounds(); float t;
+                sf::FloatRect grown({hb.position.x - r, hb.position.y - r}, {hb.size.x + 2.f*r, hb.size.y + 2.f*r});
+                if (segmentIntersectsRect(a, b, grown, &t) && t < bestT) { bestT = t; target = hostile; }
             }
+            if (target) {
+                sf::FloatRect hb = target->getBounds();
+                target->takeDamage(proj->damage);
+                if (proj->getKnockback() > 0.f) { sf::Vector2f v = proj->getVelocity(); float ln = std::sqrt(v.x*v.x + v.y*v.y); if (ln > 0.f) target->nudge(v / ln * proj->getKnockback()); }
+                try { auto &f = game.resources().font("assets/fonts/arial.ttf"); sf::Text dmgTxt(f,std::to_string((int)proj->damage),14u); dmgTxt.setFillColor(sf::Color::White); dmgTxt.setPosition({hb.position.x+hb.size.x*0.5f, hb.position.y-10.f}); combatTexts.push_back({dmgTxt,{0.f,-30.f},0.9f}); } catch(...) {}
+                proj->kill(); remove=true;
+            }
+            if (proj->expired()) remove=true;
         }
         if (remove) it = worldProjectiles.erase(it); else ++it;
     }
 
     // Remove dead hostiles & drops
-    for (auto it=entities.begin(); it!=entities.end(); ) {
-        bool erase=false; if (auto h = dynamic_cast<HostileNPC*>(it->get())) if (h->isDead()) { static std::mt19937 rng(1337u); std::uniform_real_distribution<float> dist(0.f,1.f); float r1=dist(rng), r2=dist(rng); auto hb=h->getBounds(); sf::Vector2f dp(hb.position.x+hb.size.x*0.5f, hb.position.y+hb.size.y*0.5f); if (r1<0.6f) entities.push_back(std::make_unique<ItemEntity>(std::make_shared<Item>("fiber","Plant Fiber","Common crafting material.",1), dp+sf::Vector2f{-4.f,-4.f})); if (r2<0.1f) entities.push_back(std::make_unique<ItemEntity>(std::make_shared<Item>("crystal_raw","Raw Crystal","Faintly humming shard used in rituals.",1), dp+sf::Vector2f{4.f,4.f})); erase=true; }
-        if (erase) it = entities.erase(it); else ++it;
-    }
+    for (auto *h : entities.list<HostileNPC>()) if (h->isDead()) { static std::mt19937 rng(1337u); std::uniform_real_distribution<float> dist(0.f,1.f); float r1=dist(rng), r2=dist(rng); auto hb=h->getBounds(); sf::Vector2f dp(hb.position.x+hb.size.x*0.5f, hb.position.y+hb.size.y*0.5f); if (r1<0.6f) entities.spawn<ItemEntity>(std::make_shared<Item>("fiber","Plant Fiber","Common crafting material.",1), dp+sf::Vector2f{-4.f,-4.f}); if (r2<0.1f) entities.spawn<ItemEntity>(std::make_shared<Item>("crystal_raw","Raw Crystal","Faintly humming shard used in rituals.",1), dp+sf::Vector2f{4.f,4.f}); entities.despawn(h); }
+    entities.sweep();
 
     // Combat texts
     for (auto &ct : combatTexts) { float s=dt.asSeconds(); ct.text.move(ct.vel*s); ct.lifetime -= s; auto c=ct.text.getFillColor(); if (ct.lifetime<0.4f) { c.a = (uint8_t)std::max(0.f,255.f*(ct.lifetime/0.4f)); ct.text.setFillColor(c);} }
     combatTexts.erase(std::remove_if(combatTexts.begin(), combatTexts.end(), [](const CombatText& ct){ return ct.lifetime<=0.f; }), combatTexts.end());
 
     // Crop reclamation & harvest FX
-    for (auto it=entities.begin(); it!=entities.end(); ) {
-        if (auto c = dynamic_cast<Crop*>(it->get())) if (c->isFinished()) { if (c->wasHarvested()) { harvestedCropsCount++; onCropHarvested(c->cropId()); if (!fertilizerUnlocked && harvestedCropsCount>=10) { fertilizerUnlocked=true; std::cerr << "Fertilizer unlocked after harvesting 10 crops!\n"; } for (auto &d : directives) if (d.id=="harvest_crops" && !d.satisfied) d.progress++; sf::FloatRect b=c->getBounds(); HarvestFX fx; fx.pos={b.position.x+b.size.x*0.5f,b.position.y+b.size.y*0.5f}; fx.yield=c->yieldAmount(); fx.duration=0.45f; harvestFxList.push_back(fx);} sf::FloatRect b=c->getBounds(); unsigned tx=(unsigned)std::floor((b.position.x+b.size.x*0.5f)/map.tileSize()); unsigned ty=(unsigned)std::floor((b.position.y+b.size.y*0.5f)/map.tileSize()); if (tx<map.width()&&ty<map.height()) map.setTile(tx,ty,TileMap::Plantable); it = entities.erase(it); continue; } ++it; }
+    crops.drainFinished([&](const CropField::Finished& c){
+        if (c.harvested) { harvestedCropsCount++; onCropHarvested(*c.cropId); if (!fertilizerUnlocked && harvestedCropsCount>=10) { fertilizerUnlocked=true; std::cerr << "Fertilizer unlocked after harvesting 10 crops!\n"; } for (auto &d : directives) if (d.id=="harvest_crops" && !d.satisfied) d.progress++; HarvestFX fx; float ts=(float)map.tileSize(); fx.pos={(c.tx+0.5f)*ts,(c.ty+0.5f)*ts}; fx.yield=c.yield; fx.duration=0.45f; harvestFxList.push_back(fx); }
+        map.setTile(c.tx,c.ty,TileMap::Plantable);
+    });
     for (auto &fx : harvestFxList) { if (!fx.active) continue; fx.elapsed += dt.asSeconds(); float t=fx.elapsed; if (t>=fx.duration) { fx.active=false; continue; } if (t<0.09f) fx.phase=0; else if (t<0.18f) fx.phase=1; else if (t<0.26f) fx.phase=2; else fx.phase=3; if (fx.phase==3) fx.pos.y -= 30.f * dt.asSeconds(); }
     harvestFxList.erase(std::remove_if(harvestFxList.begin(), harvestFxList.end(), [](const HarvestFX& f){ return !f.active; }), harvestFxList.end());
 
@@ -610,9 +633,9 @@ void PlayState::update(sf::Time dt) {
     if (cartRouteMode && activeCart) {
         unsigned ts = map.tileSize(); unsigned tx=(unsigned)std::floor(worldPos.x/ts); unsigned ty=(unsigned)std::floor(worldPos.y/ts);
         if (leftClick) {
-            if (loaderMode) { loaderTile={tx,ty}; loaderMode=false; }
-            else if (unloaderMode) { unloaderTile={tx,ty}; unloaderMode=false; }
-            else if (tx<map.width() && ty<map.height() && map.isTileRail(tx,ty)) activeCart->addWaypoint({tx,ty});
+            if (loaderMode) { loaderTile={tx,ty}; loaderMode=false; logistics.moveStation(loaderStation, loaderTile); }
+            else if (unloaderMode) { unloaderTile={tx,ty}; unloaderMode=false; logistics.moveStation(unloaderStation, unloaderTile); }
+            else if (tx<map.width() && ty<map.height() && map.isTileRail(tx,ty)) activeCart->addStop({tx,ty});
         }
         if (rightClick) activeCart->clearWaypoints();
     } else {
@@ -624,7 +647,14 @@ void PlayState::update(sf::Time dt) {
             bool handled=false; if (playerRidingNow && riding) { riding->dismount(); handled=true; }
             else {
                 for (auto &c : carts) if (overlaps(pb,c->getBounds())) { c->interact(player.get()); handled=true; break; }
-                if (!handled) for (auto &e : entities) if (overlaps(pb,e->getBounds())) { e->interact(player.get()); handled=true; break; }
+                if (!handled) {
+                    // closest entity (by center) among those overlapping the grown player box
+                    std::vector<Entity*> nearby; entities.queryRect(pb, nearby); Entity* pick=nullptr; float bestSq=0.f; sf::Vector2f pc=player->position();
+                    for (auto *e : nearby) { if (!overlaps(pb,e->getBounds())) continue; sf::FloatRect eb=e->getBounds(); sf::Vector2f d=sf::Vector2f(eb.position.x+eb.size.x*0.5f, eb.position.y+eb.size.y*0.5f)-pc; float dsq=d.x*d.x+d.y*d.y; if (!pick || dsq<bestSq) { pick=e; bestSq=dsq; } }
+                    float cropSq=0.f; int crop = crops.nearest(pb, pc, &cropSq);
+                    if (crop >= 0 && (!pick || cropSq < bestSq)) { crops.interact(crop); handled=true; }
+                    else if (pick) { pick->interact(player.get()); handled=true; }
+                }
             }
             if (!handled) attemptPlanting(worldPos);
             player->resetInteract();
@@ -638,7 +668,8 @@ void PlayState::update(sf::Time dt) {
     if (railTool && railTool->enabled) {
         railTool->update(worldPos, leftClick); if (leftClick) { syncRailsWithMap(); for (auto &d : directives) if (d.id=="build_rail" && !d.satisfied) d.progress=1; unsigned ts=map.tileSize(); unsigned tx=(unsigned)std::floor(worldPos.x/ts); unsigned ty=(unsigned)std::floor(worldPos.y/ts); if (tx<map.width() && ty<map.height() && map.isTileRail(tx,ty)) onRailPlaced(tx,ty); }
     } else if (leftClick) {
-        for (auto &e : entities) if (e->getBounds().contains(worldPos)) { if (auto npc = dynamic_cast<NPC*>(e.get())) dialog.start({"Hello stranger.","Nice weather today, isn't it?","Press E or Space to continue."}); else e->interact(player.get()); }
+        for (size_t i = 0; i < entities.size(); ++i) { Entity *e = entities.all()[i].get(); if (!e->getBounds().contains(worldPos)) continue; if (entities.is<NPC>(i)) dialog.start({"Hello stranger.","Nice weather today, isn't it?","Press E or Space to continue."}); else e->interact(player.get()); }
+        unsigned ts=map.tileSize(); crops.interact(crops.cropAt((unsigned)std::floor(worldPos.x/ts), (unsigned)std::floor(worldPos.y/ts)));
     }
 
     // Planting directive heuristic
@@ -670,7 +701,7 @@ void PlayState::attemptPlanting(const sf::Vector2f& worldPos) {
     if (!map.isTilePlantable(tx,ty)) return;
     items[seedIndex]->stackSize -= 1; if (items[seedIndex]->stackSize <= 0) { items.erase(items.begin()+seedIndex); }
     sf::Vector2f pos(tx*ts + ts*0.5f, ty*ts + ts*0.5f);
-    entities.push_back(std::make_unique<Crop>(game.resources(), map, pos, "wheat", 3, 6.f));
+    crops.plant(tx, ty, "wheat", 3, 6.f);
     map.setTile(tx,ty, TileMap::Empty);
     for (auto &d : directives) if (d.id=="plant_seed" && !d.satisfied) { d.progress = d.target; }
 }
@@ -740,12 +771,15 @@ void PlayState::draw() {
     if (shakeOffset>0.f) worldView.move({0.f, std::sin(hudTime*40.f)*shakeOffset*0.2f});
     win.setView(worldView);
     map.draw(win, showRailOverlay);
-    drawDecals(win); // draw ground decals beneath entities
-    for (auto &e : entities) e->draw(win);
-    for (auto &c : carts) c->draw(win);
+    // cull world-space passes against the view; margin covers sprites drawn larger than their bounds (carts)
+    const sf::FloatRect visible = view_rect(worldView, 2.f * map.tileSize());
+    drawDecals(win, visible); // draw ground decals beneath entities
+    crops.draw(win, visible);
+    for (auto &e : entities.all()) if (aabbIntersect(visible, e->getBounds())) e->draw(win);
+    for (auto &c : carts) if (aabbIntersect(visible, c->getBounds())) c->draw(win);
     if (player) player->draw(win);
     if (showTileIndicators) drawTileIndicators(win, worldView);
-    for (auto &p : worldProjectiles) p->draw(win);
+    for (auto &p : worldProjectiles) if (aabbIntersect(visible, p->getBounds())) p->draw(win);
     // draw HarvestFX
     for (auto &fx : harvestFxList) {
         float t = fx.elapsed;
@@ -799,7 +833,7 @@ void PlayState::draw() {
             circ.setFillColor(i==activeCart->currentIndex()? sf::Color(255,180,40) : sf::Color(0,160,255,150));
             win.draw(circ);
         }
-        auto drawMarker = [&](sf::Vector2u tile, sf::Color col, const char *label){
+        auto drawMarker = [&](sf::Vector2u tile, sf::Color col, const std::string& label){
             if (tile.x==UINT32_MAX) return; float tsL = (float)map.tileSize();
             sf::RectangleShape r({tsL*0.6f, tsL*0.6f}); r.setOrigin(r.getSize()/2.f);
             r.setPosition({ tile.x*tsL + tsL*0.5f, tile.y*tsL + tsL*0.5f });
@@ -812,8 +846,9 @@ void PlayState::draw() {
                 win.draw(t);
             } catch(...) {}
         };
-        drawMarker(loaderTile, sf::Color(120,255,120,200), "L");
-        drawMarker(unloaderTile, sf::Color(255,120,120,200), "U");
+        auto rateLabel = [&](const char* tag, int id){ std::ostringstream os; os.precision(2); os << tag << ' ' << std::fixed << logistics.itemsPerSecond(id) << "/s"; return os.str(); };
+        drawMarker(loaderTile, sf::Color(120,255,120,200), rateLabel("L", loaderStation));
+        drawMarker(unloaderTile, sf::Color(255,120,120,200), rateLabel("U", unloaderStation));
     }
 
     // switch to default view for HUD/static overlays
@@ -832,23 +867,13 @@ void PlayState::draw() {
         bg.setOutlineColor(sf::Color(60,60,80));
         bg.setOutlineThickness(1.f);
         win.draw(bg);
-        // tiles
-        sf::RectangleShape cell({tilePix, tilePix});
-        for (unsigned ty=0; ty<mh; ++ty) {
-            for (unsigned tx=0; tx<mw; ++tx) {
-                if (!map.isExplored(tx,ty)) continue;
-                auto t = map.getTile(tx,ty);
-                sf::Color c;
-                switch(t) {
-                    case TileMap::Empty: c = sf::Color(70,110,80); break;
-                    case TileMap::Solid: c = sf::Color(50,50,55); break;
-                    case TileMap::Plantable: c = sf::Color(110,85,40); break;
-                    case TileMap::Rail: c = sf::Color(160,140,80); break;
-                }
-                cell.setFillColor(c);
-                cell.setPosition(origin + sf::Vector2f(tx*tilePix, ty*tilePix));
-                win.draw(cell);
-            }
+        // tiles: cached texture, only cells changed since last frame are re-uploaded
+        minimap.sync(map);
+        minimap.draw(win, origin, tilePix);
+        {
+            std::ostringstream ss; ss.setf(std::ios::fixed); ss.precision(1); ss << "Explored " << map.exploredPercent() << "%";
+            sf::Text et(game.resources().font("assets/fonts/arial.ttf"), ss.str(), 11u); et.setFillColor(sf::Color(200,200,210));
+            et.setPosition(origin + sf::Vector2f(0.f, mmH + 4.f)); win.draw(et);
         }
         // entities
         if (showMinimapEntities) {
@@ -860,7 +885,7 @@ void PlayState::draw() {
                 if (px < mw && py < mh) { dot.setPosition(origin + sf::Vector2f(px*tilePix, py*tilePix)); win.draw(dot); }
             }
             dot.setFillColor(sf::Color(220,180,60));
-            for (auto &e : entities) if (dynamic_cast<HostileNPC*>(e.get())) {
+            for (auto *e : entities.list<HostileNPC>()) {
                 sf::FloatRect b = e->getBounds(); unsigned ts = map.tileSize();
                 unsigned ex = (unsigned)std::floor((b.position.x + b.size.x*0.5f)/ts);
                 unsigned ey = (unsigned)std::floor((b.position.y + b.size.y*0.5f)/ts);
@@ -1033,7 +1058,15 @@ void PlayState::addToast(const std::string& m, const sf::Color& c, float ttl) {
 
 void PlayState::updateDayNight(sf::Time dt) {
     if (!dayNightEnabled) return;
-    timeOfDay += dt.asSeconds() / dayLength; if (timeOfDay > 1.f) timeOfDay -= 1.f;
+    timeOfDay += dt.asSeconds() / dayLength; if (timeOfDay > 1.f) timeOfDay -= std::floor(timeOfDay); // any dt (fastForward)
+}
+
+void PlayState::fastForward(float seconds) {
+    FastForward ff(map, crops, railTraffic, logistics);
+    unsigned delivered = ff.run(carts, seconds, logisticsBatch, logisticsTimer);
+    if (delivered) { cartItemsMoved += (int)delivered; incrementQuestProgress("move_item_via_cart", (int)delivered); }
+    updateBuffs(sf::seconds(seconds));
+    updateDayNight(sf::seconds(seconds));
 }
 
 void PlayState::drawLighting(sf::RenderWindow& win, const sf::View& worldView) {
@@ -1051,25 +1084,12 @@ void PlayState::drawLighting(sf::RenderWindow& win, const sf::View& worldView) {
     else if (t < 0.5f) amb = lerp(day, dusk, (t-0.25f)/0.25f);
     else if (t < 0.75f) amb = lerp(dusk, night, (t-0.5f)/0.25f);
     else amb = lerp(night, dawn, (t-0.75f)/0.25f);
-    // full-screen ambient overlay (world coords, so use worldView)
-    sf::View prev = win.getView();
-    win.setView(worldView);
-    sf::RectangleShape ambientRect(worldView.getSize()); ambientRect.setOrigin(ambientRect.getSize()/2.f); ambientRect.setPosition(worldView.getCenter()); ambientRect.setFillColor(amb);
-    win.draw(ambientRect);
-    // Lamps: additive light by drawing radial alpha cutouts (simple subtractive via blending not accessible here -> approximate with lighter circles)
-    for (auto &lp : lampPositions) {
-        float radius = lampRadius; int rings = 4; for (int r=0;r<rings;++r) {
-            float frac = (float)r / rings; float rad = radius * (1.f - frac*0.25f);
-            sf::CircleShape glow(rad); glow.setOrigin({rad,rad}); glow.setPosition(lp);
-            float alpha = 110.f * (1.f-frac); // reduced from 140
-            sf::Color base(255,200,120,(uint8_t)alpha);
-            if (t < 0.4f && t>0.2f) base = lerp(base, sf::Color(255,240,200,(uint8_t)alpha), 0.4f);
-            if (t >=0.6f && t<0.9f) base = lerp(base, sf::Color(255,170,90,(uint8_t)alpha), 0.3f);
-            glow.setFillColor(base);
-            win.draw(glow);
-        }
-    }
-    win.setView(prev);
+    // the palette alpha is how strongly the tint darkens the scene; as a multiply color that is white -> tint
+    auto darken=[](sf::Color c){ auto m=[&](uint8_t v){ return (uint8_t)(255 - (255 - v) * c.a / 255); }; return sf::Color(m(c.r), m(c.g), m(c.b)); };
+    sf::Color lamp(255,200,120);
+    if (t < 0.4f && t>0.2f) lamp = lerp(lamp, sf::Color(255,240,200), 0.4f);
+    if (t >=0.6f && t<0.9f) lamp = lerp(lamp, sf::Color(255,170,90), 0.3f);
+    lightmap.draw(win, worldView, darken(amb), lampPositions, lampRadius, lamp);
 }
 
 // ---------------- Diegetic Tile Indicators ----------------
@@ -1201,9 +1221,11 @@ void PlayState::spawnWheelRut(const sf::Vector2f& a, const sf::Vector2f& b) {
     }
 }
 
-void PlayState::drawDecals(sf::RenderWindow& win) {
+void PlayState::drawDecals(sf::RenderWindow& win, const sf::FloatRect& visible) {
     // Simple shape rendering (rectangles / ellipses) as placeholders.
     for (auto &d : decals) {
+        float reach = std::max(d.size.x, d.size.y) * 1.4f; // covers rotation + oil scale
+        if (!aabbIntersect(visible, {d.pos - sf::Vector2f{reach, reach}, {reach*2.f, reach*2.f}})) continue;
         sf::RectangleShape r(d.size);
         r.setOrigin(d.size * 0.5f);
         r.setPosition(d.pos);
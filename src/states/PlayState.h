@@ -3,11 +3,20 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <limits>
 #include <SFML/Graphics.hpp>
 #include "../world/TileMap.h"
+#include "../world/FlowField.h"
+#include "../world/RailRouter.h"
+#include "../systems/RailTraffic.h"
+#include "../systems/Logistics.h"
+#include "../systems/CropField.h"
 #include "../systems/Dialog.h"
 #include "../entities/Player.h"
+#include "../entities/EntityWorld.h"
 #include "../ui/InventoryUI.h"
+#include "../ui/Minimap.h"
+#include "../ui/Lightmap.h"
 #include "../tools/RailTool.h"
 #include <unordered_map>
 #include "../systems/Quest.h" // added for quest types
@@ -26,6 +35,12 @@ public:
     void update(sf::Time) override;
     void draw() override;
 
+    // Sleep-skip: advance soil, crops, carts, logistics, buffs and day/night by `seconds` without running every
+    // tick (systems/FastForward.h). Day/night and buffs are analytic; soil, crop events, cart turns, traffic
+    // passes and logistics batches land on the ticks fixed 1/60 s stepping would give them. What is left is
+    // float rounding of long steps; `--bench fastforward` measures it over a day of a farm with looping carts.
+    // Hostiles, NPCs, projectiles and the player are left as they are.
+    void fastForward(float seconds);
     void saveGame(const std::string& path);
     void loadGame(const std::string& path);
 private:
@@ -36,11 +51,15 @@ private:
 
     Game& game;
     std::unique_ptr<Player> player;
-    std::vector<std::unique_ptr<Entity>> entities;
+    EntityWorld entities; // owns world entities + per-type lists (hostiles, rails, items, NPCs)
     std::vector<std::unique_ptr<Entity>> worldProjectiles;
     std::vector<std::unique_ptr<Cart>> carts; // rail carts managed separately
     sf::View view;
     TileMap map;
+    FlowField hostileFlow{map}; // chase field toward the player, shared by all hostiles
+    RailRouter railRouter{map}; // cart routes, cached per (from, to) and shared by all carts
+    RailTraffic railTraffic{map}; // per-tick tile reservations / signals for all carts
+    CropField crops{map}; // every planted crop (SoA, one batched update / draw)
     bool moistureOverlay = false; // toggle with M
     bool fertilityOverlay = false; // toggle with N
     std::vector<CombatText> combatTexts; // floating damage numbers
@@ -57,6 +76,9 @@ private:
     sf::Vector2u loaderTile{UINT32_MAX,UINT32_MAX};
     sf::Vector2u unloaderTile{UINT32_MAX,UINT32_MAX};
     float logisticsTimer = 0.f; // tick accumulator
+    Logistics logistics; // loader/unloader stations, stepped in fixed batches
+    int loaderStation = -1, unloaderStation = -1;
+    float logisticsBatch = 0.1f; // seconds of throughput moved per logistics pass
 
     // Respawn mechanics
     sf::Vector2f respawnPos;
@@ -79,6 +101,8 @@ private:
     bool showMinimap = true; // toggle with U
     bool enableDeathPenalty = true; // toggle with Y
     float minimapTilePixel = 2.f; // minimap tile pixel size, cycle with J (2,3,4)
+    Minimap minimap; // baked 1 px per tile, scaled by minimapTilePixel when drawn
+    sf::Vector2i lastRevealTile{std::numeric_limits<int>::min(), std::numeric_limits<int>::min()}; // player tile the fog disc was last stamped at
     bool showMinimapViewRect = true; // toggle with V
     bool showMinimapEntities = true; // toggle with G (draw entity icons)
     bool showHelpOverlay = false; // toggle with H
@@ -88,6 +112,8 @@ private:
     bool tryMovePlayer(const sf::Vector2f& desired);
     void syncRailsWithMap();
     void spawnProjectile(std::unique_ptr<Entity> p);
+    void applyTunables(); // copy reloadable tunables into map / flow field / stations / lightmap / player
+    uint32_t tunablesVersion = 0;
 
     DialogManager dialog;
 
@@ -207,6 +233,7 @@ private:
     bool dayNightEnabled = true;
     std::vector<sf::Vector2f> lampPositions; // static lamp world positions
     float lampRadius = 140.f; // reduced light falloff radius (was 180)
+    Lightmap lightmap; // ambient + lamps, multiplied over the world once per frame
     void updateDayNight(sf::Time dt);
     void drawLighting(sf::RenderWindow& win, const sf::View& worldView);
 
@@ -231,7 +258,7 @@ private:
     std::vector<Decal> decals; // static + dynamic
     void initDecals();
     void spawnWheelRut(const sf::Vector2f& a, const sf::Vector2f& b);
-    void drawDecals(sf::RenderWindow& win);
+    void drawDecals(sf::RenderWindow& win, const sf::FloatRect& visible); // skips decals outside visible
 
     // Lightweight toast/status messages for key feedback
     struct Toast { std::string msg; float time=0.f; float ttl=2.f; sf::Color color; };
@@ -0,0 +1,231 @@
+#include "CropField.h"
+#include "../entities/Crop.h"
+#include "../world/TileMap.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../core/Tunables.h"
+
+void CropField::resolve(Config& c) {
+    const CropConfig* cfg = Crop::getConfig(c.id);
+    float total = c.totalTime;
+    const Tunables::Farming& ft = tunables().farming;
+    c.moistureScale = ft.moistureFactor; c.fertilityScale = ft.fertilityFactor;
+    total = ft.growthSeconds(c.id, total);
+    c.legacy = cfg == nullptr;
+    std::vector<float> rates;
+    if (cfg) {
+        for (float d : cfg->stageDurations) rates.push_back(1.f / std::max(0.001f, d));
+        if (rates.empty()) rates.push_back(1.f);
+        c.idealMin = cfg->moistureIdealMin; c.idealMax = cfg->moistureIdealMax;
+        c.invLowSpan = 1.f / std::max(0.01f, cfg->moistureIdealMin);
+        c.invHighSpan = 1.f / std::max(0.01f, 1.f - cfg->moistureIdealMax);
+        c.deathThreshold = cfg->moistureDeathThreshold; c.witherSeconds = cfg->moistureWitherSeconds;
+        c.yieldBonusScale = cfg->fertilityYieldBonusScale; c.fertilityConsumption = cfg->fertilityConsumption;
+        c.baseYield = cfg->baseYield; c.maxQuality = cfg->maxQuality;
+    } else {
+        // legacy: `stages` equal slices of the total time, no drought
+        rates.assign(std::max(1, c.stages), float(std::max(1, c.stages)) / std::max(0.001f, total));
+        c.yieldBonusScale = 2.f; c.fertilityConsumption = 0.02f; c.baseYield = 1; c.maxQuality = 2;
+    }
+    if (rates.size() > 255) rates.resize(255);
+    c.stages = int(rates.size());
+    c.rateOffset = unsigned(stageRate.size());
+    stageRate.insert(stageRate.end(), rates.begin(), rates.end());
+}
+
+uint16_t CropField::configFor(const std::string& id, int stages, float totalTime) {
+    for (size_t i = 0; i < configs.size(); ++i) {
+        const Config &c = configs[i];
+        if (c.id == id && (!c.legacy || (c.stages == stages && c.totalTime == totalTime))) return uint16_t(i);
+    }
+    Config c; c.id = id; c.stages = stages; c.totalTime = totalTime;
+    resolve(c);
+    configs.push_back(std::move(c));
+    return uint16_t(configs.size() - 1);
+}
+
+void CropField::resolveConfigs() {
+    // stage counts may change, so lay the rate table out again; stages past the new count clamp
+    for (size_t i = 0; i < tile.size(); ++i) advanceTo(i, clock);
+    stageRate.clear();
+    for (auto &c : configs) resolve(c);
+    for (size_t i = 0; i < tile.size(); ++i) { stage[i] = uint8_t(std::min<int>(stage[i], configs[config[i]].stages - 1)); schedule(i); }
+}
+
+void CropField::ensureIndex() {
+    if (mapW == map.width() && mapH == map.height()) return;
+    // map replaced: crops can't carry over
+    tile.clear(); config.clear(); stage.clear(); flags.clear(); growth.clear(); drought.clear(); yield.clear(); quality.clear();
+    rate.clear(); droughtRate.clear(); since.clear(); gen.clear();
+    wheel.clear(tickAt(clock));
+    mapW = map.width(); mapH = map.height();
+    indexOf.assign(size_t(mapW) * mapH, -1);
+}
+
+int CropField::plant(unsigned tx, unsigned ty, const std::string& cropId, int stages, float totalTime) {
+    ensureIndex();
+    if (tx >= mapW || ty >= mapH || indexOf[tx + ty * mapW] >= 0) return -1;
+    int i = int(tile.size());
+    indexOf[tx + ty * mapW] = i;
+    tile.push_back(tx + ty * mapW); config.push_back(configFor(cropId, stages, totalTime));
+    stage.push_back(0); flags.push_back(0); growth.push_back(0.f); drought.push_back(0.f); yield.push_back(1); quality.push_back(1);
+    rate.push_back(0.f); droughtRate.push_back(0.f); since.push_back(clock); gen.push_back(0);
+    schedule(size_t(i));
+    return i;
+}
+
+void CropField::removeAt(size_t i) {
+    size_t last = tile.size() - 1;
+    indexOf[tile[i]] = -1;
+    if (i != last) {
+        tile[i] = tile[last]; config[i] = config[last]; stage[i] = stage[last]; flags[i] = flags[last];
+        growth[i] = growth[last]; drought[i] = drought[last]; yield[i] = yield[last]; quality[i] = quality[last];
+        rate[i] = rate[last]; droughtRate[i] = droughtRate[last]; since[i] = since[last]; gen[i] = gen[last];
+        indexOf[tile[i]] = int32_t(i);
+    }
+    tile.pop_back(); config.pop_back(); stage.pop_back(); flags.pop_back(); growth.pop_back(); drought.pop_back(); yield.pop_back(); quality.pop_back();
+    rate.pop_back(); droughtRate.pop_back(); since.pop_back(); gen.pop_back();
+}
+
+void CropField::advanceTo(size_t i, double t) {
+    double e = t - since[i];
+    if (e <= 0.0) return;
+    growth[i] += float(rate[i] * e);
+    drought[i] = std::max(0.f, float(drought[i] + droughtRate[i] * e));
+    since[i] = t;
+}
+
+void CropField::schedule(size_t i) {
+    gen[i] = ++nextGen; // any wake-up already filed for this crop is now stale
+    rate[i] = droughtRate[i] = 0.f;
+    if (flags[i]) return;
+    const Config &c = configs[config[i]];
+    unsigned tx = tile[i] % mapW, ty = tile[i] / mapW;
+    float m, f;
+    bool settled = map.soilAhead(tx, ty, float(since[i] - soilClock), m, f);
+    float mFactor = 1.f;
+    if (!c.legacy) {
+        droughtRate[i] = m < c.deathThreshold ? 1.f : -0.5f;
+        if (m < c.idealMin) mFactor = 0.3f + 0.7f * (m * c.invLowSpan);
+        else if (m > c.idealMax) mFactor = 1.f - 0.5f * ((m - c.idealMax) * c.invHighSpan);
+    } else {
+        mFactor = (m < 0.4f) ? (0.5f + 0.5f * (m / 0.4f)) : (m <= 0.7f ? 1.f : (1.f - (m - 0.7f) * 0.6f));
+        mFactor = std::max(0.3f, mFactor);
+    }
+    float factor = std::min(4.f, mFactor * c.moistureScale * (0.4f + 0.6f * f) * c.fertilityScale);
+    // growth past the last stage changes nothing, so a ripe crop only waits on withering
+    if (stage[i] < c.stages - 1) rate[i] = factor * stageRate[c.rateOffset + stage[i]];
+    double wait = -1.0;
+    auto soonest = [&](double w) { if (wait < 0.0 || w < wait) wait = std::max(0.0, w); };
+    if (rate[i] > 0.f) soonest((1.0 - growth[i]) / rate[i]);
+    if (droughtRate[i] > 0.f) soonest(double(c.witherSeconds) - drought[i]);
+    if (!settled) soonest(DriftRecheckSeconds);
+    if (wait < 0.0) return; // idle until its tile's soil is edited
+    wheel.schedule(uint64_t(std::ceil((since[i] + wait) / TickSeconds - 1e-6)), Wake{tile[i], gen[i]});
+}
+
+void CropField::wake(size_t i, double t) {
+    advanceTo(i, t);
+    const Config &c = configs[config[i]];
+    if (!c.legacy && drought[i] > c.witherSeconds) {
+        flags[i] |= Withered;
+        std::cerr << "Crop withered: " << c.id << " at tile " << tile[i] % mapW << "," << tile[i] / mapW << "\n";
+        return;
+    }
+    float &g = growth[i]; uint8_t &st = stage[i];
+    while (g >= 1.f && st < c.stages - 1) { g -= 1.f; ++st; }
+    if (c.legacy && st == c.stages - 1) g = std::min(g, 1.f);
+    schedule(i);
+}
+
+void CropField::update(sf::Time dt, bool soilLags) {
+    ensureIndex();
+    if (tunablesVersion != tunables().version) { tunablesVersion = tunables().version; resolveConfigs(); } // live reload
+    // soil written since the last tick applies to this tick's growth, as when every crop re-read its tile each tick
+    if (map.drainSoilEdits(soilEdits)) {
+        for (size_t i = 0; i < tile.size(); ++i) { advanceTo(i, clock); schedule(i); }
+    } else {
+        for (uint32_t t : soilEdits) { int i = indexOf[t]; if (i >= 0) { advanceTo(size_t(i), clock); schedule(size_t(i)); } }
+    }
+    soilClock = soilLags ? clock : clock + dt.asSeconds(); // normal ticks step the soil first
+    clock += dt.asSeconds();
+    // a long dt (fastForward) still applies each event at its own tick, not at the end of the span
+    wheel.advance(tickAt(clock), [&](const Wake& w, uint64_t) {
+        int i = indexOf[w.tile];
+        if (i >= 0 && gen[i] == w.gen && !flags[i]) wake(size_t(i), std::min(clock, wheel.now() * double(TickSeconds)));
+    });
+    soilClock = clock; // the caller steps the soil right after a soilLags update
+}
+
+int CropField::cropAt(unsigned tx, unsigned ty) const {
+    if (tx >= mapW || ty >= mapH || indexOf.empty()) return -1;
+    return indexOf[tx + ty * mapW];
+}
+
+bool CropField::ripe(int i) const { return i >= 0 && !flags[i] && stage[i] == configs[config[i]].stages - 1; }
+
+sf::Vector2f CropField::center(int i) const {
+    float ts = float(map.tileSize());
+    return {(tile[i] % mapW + 0.5f) * ts, (tile[i] / mapW + 0.5f) * ts};
+}
+
+int CropField::nearest(const sf::FloatRect& area, sf::Vector2f p, float* distSq) const {
+    if (indexOf.empty()) return -1;
+    float ts = float(map.tileSize());
+    int x0 = std::max(0, int(std::floor(area.position.x / ts))), y0 = std::max(0, int(std::floor(area.position.y / ts)));
+    int x1 = std::min(int(mapW) - 1, int(std::floor((area.position.x + area.size.x) / ts)));
+    int y1 = std::min(int(mapH) - 1, int(std::floor((area.position.y + area.size.y) / ts)));
+    int best = -1; float bestSq = 0.f;
+    for (int y = y0; y <= y1; ++y) for (int x = x0; x <= x1; ++x) {
+        int i = indexOf[x + y * mapW]; if (i < 0) continue;
+        sf::Vector2f d = center(i) - p; float dsq = d.x*d.x + d.y*d.y;
+        if (best < 0 || dsq < bestSq) { best = i; bestSq = dsq; }
+    }
+    if (distSq) *distSq = bestSq;
+    return best;
+}
+
+bool CropField::interact(int i) {
+    if (i < 0 || size_t(i) >= tile.size()) return false;
+    if (flags[i] & Withered) { flags[i] |= Harvested; return true; }
+    if (flags[i] || !ripe(i)) return true;
+    const Config &c = configs[config[i]];
+    unsigned tx = tile[i] % mapW, ty = tile[i] / mapW;
+    float fert = map.fertility(tx, ty);
+    yield[i] = uint8_t(std::clamp((int)std::round(c.baseYield * (1.f + fert * c.yieldBonusScale)), 1, 255));
+    // quality from fertility bands
+    int q = 1;
+    if (!c.legacy) { if (fert > 0.8f) q = std::min(c.maxQuality, 3); else if (fert > 0.55f) q = std::min(c.maxQuality, 2); }
+    else if (fert > 0.75f) q = 2;
+    quality[i] = uint8_t(q);
+    flags[i] |= Harvested;
+    map.adjustFertility(tx, ty, -c.fertilityConsumption);
+    std::cerr << "Crop harvested: " << c.id << " at tile " << tx << "," << ty << " yield=" << int(yield[i]) << " quality=" << q << " fert=" << fert << "\n";
+    return true;
+}
+
+void CropField::draw(sf::RenderTarget& target, const sf::FloatRect& visible) {
+    if (indexOf.empty() || tile.empty()) return;
+    float ts = float(map.tileSize());
+    int x0 = std::max(0, int(std::floor(visible.position.x / ts)) - 1), y0 = std::max(0, int(std::floor(visible.position.y / ts)) - 1);
+    int x1 = std::min(int(mapW) - 1, int(std::floor((visible.position.x + visible.size.x) / ts)) + 1);
+    int y1 = std::min(int(mapH) - 1, int(std::floor((visible.position.y + visible.size.y) / ts)) + 1);
+    quads.clear();
+    for (int y = y0; y <= y1; ++y) for (int x = x0; x <= x1; ++x) {
+        int i = indexOf[x + y * mapW]; if (i < 0 || (flags[i] & Harvested)) continue;
+        const Config &c = configs[config[i]];
+        int st = stage[i], last = std::max(1, c.stages - 1);
+        // same look as the old crop shape: darker per stage, greener when ripe, grows from stage 1 on
+        sf::Color col(uint8_t(std::max(0, 200 - 10*st)), uint8_t(std::max(0, 180 - 5*st)), 60);
+        if (st == c.stages - 1 && st > 0) col.g = uint8_t(std::min(255, col.g + 30));
+        if (flags[i] & Withered) col = sf::Color(90,70,50,180);
+        float half = 10.f * (st == 0 ? 1.f : 0.8f + float(st) / last * 0.6f);
+        sf::Vector2f p = center(i);
+        p.x += std::sin(p.x*0.15f + windTime * windFreq) * windAmp * (0.4f + 0.6f * float(st) / last);
+        sf::Vector2f a{p.x - half, p.y - half}, b{p.x + half, p.y + half};
+        quads.append({a, col}); quads.append({{b.x, a.y}, col}); quads.append({b, col});
+        quads.append({a, col}); quads.append({b, col}); quads.append({{a.x, b.y}, col});
+    }
+    if (quads.getVertexCount()) target.draw(quads);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+#include "../core/TimerWheel.h"
+class TileMap;
+
+// Every planted crop as structure-of-arrays (tile, config, stage, growth, drought, flags). Crop configs
+// (data/crops.json via Crop::loadConfigs) and the farming tunables are resolved into a flat table when a
+// crop kind is first planted, or again on resolveConfigs(). Growth rules match the old Crop entity:
+// per-stage durations scaled by a moisture/fertility factor, withering after prolonged drought; crops
+// without a config fall back to the legacy total-time growth and moisture curve.
+// Crops are not stepped per tick: each keeps its current growth / drought rates and sits in a timer wheel
+// until its next stage change or wither, so a tick costs the events due in it. Soil edits on a crop's tile
+// (TileMap::drainSoilEdits) re-read its rates; while the tile's soil is still relaxing toward the targets
+// the crop re-reads it every DriftRecheckSeconds (rates are piecewise constant in between).
+class CropField {
+public:
+    struct Finished { unsigned tx, ty; const std::string* cropId; bool harvested; int yield; int quality; };
+
+    explicit CropField(TileMap& map) : map(map) {}
+    int plant(unsigned tx, unsigned ty, const std::string& cropId, int stages = 3, float totalTime = 6.f); // crop index, -1 if taken
+    // soilLags: the map's soil is stepped over dt only after this call (fastForward's single long span), so
+    // crops re-reading their tile inside the span read it ahead to their own event time
+    void update(sf::Time dt, bool soilLags = false);
+    // hand every harvested / withered crop to f, then drop it (indices of other crops may change)
+    template<class F> void drainFinished(F&& f);
+    void resolveConfigs(); // re-read configs + tunables into the existing table (update() does this when tunables reload)
+
+    int cropAt(unsigned tx, unsigned ty) const;
+    int nearest(const sf::FloatRect& area, sf::Vector2f p, float* distSq = nullptr) const; // crop whose tile overlaps area, closest to p
+    bool interact(int i); // harvest when ripe; true if i is a crop (ripe or not), like touching the old entity
+    sf::Vector2f center(int i) const;
+    size_t size() const { return tile.size(); }
+    bool ripe(int i) const;
+    int growthStage(int i) const { return i >= 0 && size_t(i) < tile.size() ? int(stage[i]) : -1; }
+    bool withered(int i) const { return i >= 0 && size_t(i) < tile.size() && (flags[i] & Withered); }
+    size_t pendingEvents() const { return wheel.pending(); }
+
+    void setWind(float time, float amplitude, float frequency) { windTime = time; windAmp = amplitude; windFreq = frequency; }
+    void draw(sf::RenderTarget& target, const sf::FloatRect& visible); // one batched draw of the visible crops
+
+private:
+    enum : uint8_t { Harvested = 1, Withered = 2 };
+    struct Config {
+        std::string id; int stages = 3; float totalTime = 6.f; // lookup key (legacy crops differ per stages/time)
+        bool legacy = false; // no crops.json entry
+        unsigned rateOffset = 0; // stageRate[rateOffset + stage] = growth per second at factor 1
+        float idealMin = 0.35f, idealMax = 0.65f, invLowSpan = 1.f, invHighSpan = 1.f;
+        float deathThreshold = 0.15f, witherSeconds = 25.f;
+        float moistureScale = 1.f, fertilityScale = 1.f; // farming.moisture_factor / fertility_factor
+        float yieldBonusScale = 2.f, fertilityConsumption = 0.02f; int baseYield = 1, maxQuality = 3;
+    };
+    uint16_t configFor(const std::string& id, int stages, float totalTime);
+    void resolve(Config& c);
+    void ensureIndex();
+    void removeAt(size_t i);
+    void advanceTo(size_t i, double t); // fold the rates since since[i] into growth / drought
+    void schedule(size_t i); // re-read the tile's soil into the rates and file the next wake-up from since[i]
+    void wake(size_t i, double t); // a due event at time t: apply stage changes / withering, then schedule again
+    uint64_t tickAt(double t) const { return uint64_t(t / TickSeconds + 1e-6); }
+
+    TileMap& map;
+    unsigned mapW = 0, mapH = 0;
+    std::vector<Config> configs;
+    std::vector<float> stageRate;
+    uint32_t tunablesVersion = 0; // Tunables::version the table was resolved against
+    std::vector<int32_t> indexOf; // tile -> crop index, -1 when empty
+    // SoA, one entry per crop
+    std::vector<uint32_t> tile; // x + y*w
+    std::vector<uint16_t> config;
+    std::vector<uint8_t> stage, flags;
+    std::vector<float> growth, drought;
+    std::vector<uint8_t> yield, quality; // set on harvest
+    std::vector<float> rate, droughtRate; // per second, fixed between events
+    std::vector<double> since; // clock time growth / drought were last folded in
+    std::vector<uint32_t> gen; // bumped on every schedule; wheel entries with an older stamp are stale
+    static constexpr float TickSeconds = 1.f / 60.f; // wheel resolution
+    static constexpr float DriftRecheckSeconds = 0.25f;
+    struct Wake { uint32_t tile, gen; }; // keyed by tile, since removal moves crop indices
+    TimerWheel<Wake> wheel;
+    double clock = 0.0; // seconds simulated
+    double soilClock = 0.0; // clock time the map's soil reflects (behind clock only inside a soilLags update)
+    uint32_t nextGen = 0;
+    std::vector<uint32_t> soilEdits; // scratch for TileMap::drainSoilEdits
+    sf::VertexArray quads{sf::PrimitiveType::Triangles};
+    float windTime = 0.f, windAmp = 4.f, windFreq = 0.8f;
+};
+
+template<class F> void CropField::drainFinished(F&& f) {
+    for (size_t i = tile.size(); i-- > 0; ) {
+        if (!flags[i]) continue;
+        bool harvested = flags[i] == Harvested; // touching a withered crop just clears it
+        f(Finished{tile[i] % mapW, tile[i] / mapW, &configs[config[i]].id, harvested, harvested ? int(yield[i]) : 0, harvested ? int(quality[i]) : 0});
+        removeAt(i);
+    }
+}
@@ -0,0 +1,77 @@
+#include "FastForward.h"
+#include "CropField.h"
+#include "RailTraffic.h"
+#include "Logistics.h"
+#include "../entities/Cart.h"
+#include "../world/TileMap.h"
+#include <algorithm>
+#include <cmath>
+
+bool FastForward::nearStation(const Cart& c) const {
+    const float ts = (float)map.tileSize();
+    sf::Vector2f p = c.worldPosition();
+    sf::Vector2u next;
+    if (p.x >= 0.f && p.y >= 0.f && logistics.hasStationAt({ (unsigned)(p.x / ts), (unsigned)(p.y / ts) })) return true;
+    return c.nextTile(next) && logistics.hasStationAt(next);
+}
+
+unsigned FastForward::run(const std::vector<std::unique_ptr<Cart>>& carts, float seconds, float batchSeconds, float& batchTimer) {
+    stats = {};
+    const float tick = sf::seconds(1.f / 60.f).asSeconds(); // the game loop's step as the systems see it
+    const uint32_t n = (uint32_t)std::llround(std::max(0.f, seconds) / tick);
+    if (!n) return 0;
+    stats.ticks = n;
+    // soil and crops: one call each, crops first so their events read the soil ahead to their own tick
+    crops.update(sf::seconds(n * tick), true);
+    map.updateSoil(sf::seconds(n * tick));
+    // the batch timer runs tick by tick as in PlayState::update, so batches land on the same ticks
+    batchTicks.clear();
+    for (uint32_t k = 1; k <= n; ++k) {
+        batchTimer += tick;
+        while (batchTimer >= batchSeconds) { batchTimer -= batchSeconds; batchTicks.push_back(k); }
+    }
+    const size_t nc = carts.size();
+    at.assign(nc, 0); parked.assign(nc, 0);
+    bool pass = true; // the last regular tick may have left a cart at a tile centre
+    uint32_t lastPass = 0;
+    size_t nextBatch = 0;
+    unsigned delivered = 0;
+    for (uint32_t k = 1; k <= n; ) { // tick k: pass on the positions after k-1 ticks, moves, then batches
+        if (pass) {
+            traffic.update(carts, sf::seconds((k - lastPass) * tick)); // held carts still accrue the skipped ticks
+            lastPass = k; pass = false; ++stats.passes;
+            for (size_t i = 0; i < nc; ++i) if (parked[i] && !carts[i]->isHeld()) { parked[i] = 0; at[i] = k - 1; }
+        }
+        uint32_t batchAt = nextBatch < batchTicks.size() ? batchTicks[nextBatch] : n;
+        for (size_t i = 0; i < nc; ++i) {
+            if (parked[i] || at[i] != k - 1) continue;
+            Cart &c = *carts[i];
+            float t = c.timeToTarget();
+            if (t < 0.f) { parked[i] = 1; continue; } // held or routeless: stays put
+            uint32_t m = 1; // at a centre the pass decides each tick; the turn itself is stepped singly too
+            if (!c.atTileCenter()) {
+                m = (uint32_t)std::max(1.f, std::floor(t / tick - 1e-4f)); // whole ticks that stay short of the turn
+                m = std::min(m, n - (k - 1));
+                if (m > 1 && nearStation(c)) m = std::max(1u, std::min(m, batchAt - (k - 1)));
+            }
+            sf::Vector2f p0 = c.worldPosition(); size_t w0 = c.currentIndex();
+            c.update(sf::seconds(m * tick));
+            at[i] += m; ++stats.cartSteps;
+            if (m > 1) continue;
+            bool moved = c.worldPosition() != p0;
+            if (c.currentIndex() != w0 || (moved && c.atTileCenter())) pass = true; // new traffic inputs for tick k+1
+            else if (!moved) parked[i] = 1; // end of a route: unchanged until a pass says otherwise
+        }
+        uint32_t next = pass ? k + 1 : n + 1;
+        for (size_t i = 0; i < nc; ++i) if (!parked[i]) next = std::min(next, at[i] + 1);
+        // batches up to there: carts near a station stopped at the first of them, the rest are not on one
+        for (; nextBatch < batchTicks.size() && batchTicks[nextBatch] < next; ++nextBatch) {
+            delivered += logistics.update(carts, sf::seconds(batchSeconds), map.tileSize()).second;
+            ++stats.batches;
+        }
+        k = next;
+    }
+    // count the held carts' wait up to the last tick (same decisions as the next regular pass)
+    if (lastPass < n) traffic.update(carts, sf::seconds((n - lastPass) * tick));
+    return delivered;
+}
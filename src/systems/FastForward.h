@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+class TileMap;
+class CropField;
+class RailTraffic;
+class Logistics;
+class Cart;
+
+// Skips simulated time in one call (sleep, debug skip) with the results of stepping the fixed 1/60 s tick.
+//  - Soil and crops take the whole span in one call each: relaxation clamps at its targets, so one long
+//    updateSoil is exact, and crops fire every event at its own tick, reading the soil ahead to that time.
+//  - Each cart runs on its own clock: straight travel toward the next tile centre is one long update and
+//    only the ticks around a turn are stepped singly. A RailTraffic pass only decides anything for carts at
+//    a tile centre, so one runs on the tick after a cart arrives at a centre or switches waypoint (with dt
+//    covering the skipped ticks); held carts sit parked until a pass lets them go.
+//  - Logistics batches fall on the ticks PlayState's batch timer would fire them. Budget accrual is linear,
+//    so batches with no cart next to a station are a plain loop of updates; a cart whose tile or next tile
+//    is a station stops at each batch tick, so the transfer sees the tile it really is on.
+// `--bench fastforward` compares the result against fixed stepping.
+class FastForward {
+public:
+    struct Stats { uint32_t ticks = 0, passes = 0, cartSteps = 0, batches = 0; };
+
+    FastForward(TileMap& map, CropField& crops, RailTraffic& traffic, Logistics& logistics)
+        : map(map), crops(crops), traffic(traffic), logistics(logistics) {}
+    // advance by `seconds` (rounded to whole ticks); batchTimer is the caller's logistics accumulator and ends
+    // where the fixed ticks would leave it; returns the units unloaded
+    unsigned run(const std::vector<std::unique_ptr<Cart>>& carts, float seconds, float batchSeconds, float& batchTimer);
+    const Stats& lastStats() const { return stats; }
+
+private:
+    bool nearStation(const Cart& c) const; // its tile or the tile it is heading to holds a station
+    TileMap& map;
+    CropField& crops;
+    RailTraffic& traffic;
+    Logistics& logistics;
+    std::vector<uint32_t> at;         // per cart: ticks its position reflects
+    std::vector<uint8_t> parked;      // per cart: nothing to do until the next traffic pass
+    std::vector<uint32_t> batchTicks; // ticks a logistics batch fires after
+    Stats stats;
+};
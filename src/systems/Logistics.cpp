@@ -0,0 +1,88 @@
+#include "Logistics.h"
+#include "../entities/Cart.h"
+#include <algorithm>
+#include <cmath>
+
+int Logistics::addStation(Kind kind, sf::Vector2u tile, float itemsPerSec, Inventory* inventory) {
+    auto s = std::make_unique<Station>();
+    s->kind = kind; s->tile = tile; s->itemsPerSec = itemsPerSec;
+    s->inventory = inventory ? inventory : &s->buffer;
+    stations.push_back(std::move(s));
+    reindex();
+    return (int)stations.size() - 1;
+}
+
+void Logistics::moveStation(int id, sf::Vector2u tile) {
+    if (auto *s = station(id)) { s->tile = tile; reindex(); }
+}
+
+void Logistics::reindex() {
+    byTile.clear();
+    for (size_t i = 0; i < stations.size(); ++i)
+        if (stations[i]->tile.x != UINT32_MAX) byTile[tileKey(stations[i]->tile)] = (int)i; // last placed wins a shared tile
+}
+
+unsigned Logistics::load(Station& s, Cart& cart, unsigned units) {
+    unsigned done = 0;
+    auto &slots = s.inventory->itemsMutable();
+    for (auto &stack : slots) {
+        if (done >= units) break;
+        if (!stack || stack->stackSize <= 0 || (!s.filter.empty() && stack->id != s.filter)) continue;
+        unsigned take = std::min<unsigned>(units - done, (unsigned)stack->stackSize);
+        take = cart.loadUnits(*stack, take);
+        if (!take) break; // cart full
+        stack->stackSize -= (int)take; done += take;
+    }
+    slots.erase(std::remove_if(slots.begin(), slots.end(), [](const ItemPtr& p){ return !p || p->stackSize <= 0; }), slots.end());
+    return done;
+}
+
+unsigned Logistics::unload(Station& s, Cart& cart, unsigned units) {
+    unsigned done = 0;
+    while (done < units) {
+        ItemPtr slice = cart.unloadUnits(s.filter, units - done);
+        if (!slice) break;
+        if (!s.inventory->addItem(slice)) { cart.loadUnits(*slice, (unsigned)slice->stackSize); break; } // destination full: put it back
+        done += (unsigned)slice->stackSize;
+    }
+    return done;
+}
+
+std::pair<unsigned, unsigned> Logistics::update(const std::vector<std::unique_ptr<Cart>>& carts, sf::Time dt, unsigned tileSize) {
+    const float sec = dt.asSeconds();
+    for (auto &s : stations) {
+        s->budget = std::min<double>(s->budget + s->itemsPerSec * sec, std::max(1.f, s->itemsPerSec * MaxBankSeconds));
+        s->windowTime += sec;
+    }
+    unsigned loaded = 0, unloaded = 0;
+    if (!byTile.empty()) {
+        const float ts = (float)tileSize;
+        for (auto &c : carts) {
+            sf::Vector2f p = c->worldPosition();
+            if (p.x < 0.f || p.y < 0.f) continue;
+            auto it = byTile.find(tileKey({ (unsigned)(p.x / ts), (unsigned)(p.y / ts) }));
+            if (it == byTile.end()) continue;
+            Station &s = *stations[it->second];
+            unsigned units = (unsigned)std::floor(s.budget);
+            if (!units) continue;
+            unsigned n = s.kind == Kind::Loader ? load(s, *c, units) : unload(s, *c, units);
+            s.budget -= n; s.moved += n; s.windowMoved += n;
+            (s.kind == Kind::Loader ? loaded : unloaded) += n;
+        }
+    }
+    for (auto &s : stations) {
+        if (s->windowTime < RateWindow) continue;
+        s->rate = s->windowMoved / s->windowTime;
+        s->windowMoved = 0; s->windowTime = 0.f;
+    }
+    return {loaded, unloaded};
+}
+
+nlohmann::json Logistics::statsJson() const {
+    nlohmann::json arr = nlohmann::json::array();
+    for (auto &s : stations) {
+        arr.push_back({ {"kind", s->kind == Kind::Loader ? "loader" : "unloader"}, {"tile", {s->tile.x, s->tile.y}},
+                        {"cap_items_per_sec", s->itemsPerSec}, {"items_per_sec", s->rate}, {"total", s->moved} });
+    }
+    return arr;
+}
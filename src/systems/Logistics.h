@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+#include <nlohmann/json.hpp>
+#include "Inventory.h"
+class Cart;
+
+// Loader/unloader stations on rail tiles (docs/features/rails.md "Loading Algorithm"). Each update is one
+// batched pass: every station accrues throughput budget (items/sec, banked for at most one second), then
+// each cart standing on a station tile moves whole stack slices in one step, bounded by the budget, the
+// stacks available and the free space on the other side. Loaders pull from their inventory into the cart,
+// unloaders push cart contents into theirs. Each station keeps a total and a rolling items/sec figure.
+class Logistics {
+public:
+    enum class Kind : uint8_t { Loader, Unloader };
+    struct Station {
+        Kind kind = Kind::Loader;
+        sf::Vector2u tile{UINT32_MAX, UINT32_MAX}; // UINT32_MAX = not placed
+        Inventory buffer{32};            // used when no external inventory is bound
+        Inventory* inventory = nullptr;  // loader: source, unloader: destination
+        std::string filter;              // item id to move; empty moves anything
+        float itemsPerSec = 4.f;         // throughput cap
+        double budget = 0.0;             // items that may move right now
+        uint64_t moved = 0;              // lifetime total
+        float rate = 0.f;                // items/sec over the last completed window
+        unsigned windowMoved = 0; float windowTime = 0.f;
+    };
+
+    int addStation(Kind kind, sf::Vector2u tile, float itemsPerSec, Inventory* inventory = nullptr);
+    void moveStation(int id, sf::Vector2u tile);
+    Station* station(int id) { return id >= 0 && id < (int)stations.size() ? stations[id].get() : nullptr; }
+    bool hasStationAt(sf::Vector2u tile) const { return byTile.count(tileKey(tile)) != 0; }
+    // one batched transfer pass; returns {units loaded, units unloaded}
+    std::pair<unsigned, unsigned> update(const std::vector<std::unique_ptr<Cart>>& carts, sf::Time dt, unsigned tileSize);
+    float itemsPerSecond(int id) const { return id >= 0 && id < (int)stations.size() ? stations[id]->rate : 0.f; }
+    nlohmann::json statsJson() const; // per station: kind, tile, cap, items/sec, total
+
+private:
+    static constexpr float RateWindow = 1.f; // seconds per items/sec sample
+    static constexpr float MaxBankSeconds = 1.f;
+    unsigned load(Station& s, Cart& cart, unsigned units);
+    unsigned unload(Station& s, Cart& cart, unsigned units);
+    void reindex();
+    static uint64_t tileKey(sf::Vector2u t) { return (uint64_t(t.x) << 32) | t.y; }
+    std::vector<std::unique_ptr<Station>> stations; // stable addresses (Station::inventory may point at buffer)
+    std::unordered_map<uint64_t, int> byTile; // tile -> station id
+};
@@ -0,0 +1,81 @@
+#include "RailTraffic.h"
+#include "../entities/Cart.h"
+#include "../world/TileMap.h"
+#include <algorithm>
+#include <bitset>
+
+uint32_t RailTraffic::key(sf::Vector2u t) const { return t.x + t.y * map.width(); }
+
+bool RailTraffic::junction(sf::Vector2u t) const { return std::bitset<4>(map.railBits(t.x, t.y)).count() >= 3; }
+
+bool RailTraffic::reserve(sf::Vector2u t, uint32_t slot) {
+    auto [it, fresh] = reserved.emplace(key(t), slot);
+    return fresh || it->second == slot;
+}
+
+bool RailTraffic::isFree(sf::Vector2u t, uint32_t slot) const {
+    auto it = reserved.find(key(t));
+    return it == reserved.end() || it->second == slot;
+}
+
+bool RailTraffic::junctionPath(const Cart& c, size_t ahead, std::vector<sf::Vector2u>& out) const {
+    out.clear();
+    sf::Vector2u t;
+    for (size_t k = ahead; out.size() < MaxBlock && c.routeAhead(k, t); ++k) {
+        out.push_back(t);
+        if (junction(t)) continue;
+        bool clear = true; sf::Vector2u u;
+        for (unsigned j = 1; j <= ClearAhead && clear && c.routeAhead(k + j, u); ++j) clear = !junction(u);
+        if (clear) break;
+    }
+    return !out.empty();
+}
+
+void RailTraffic::update(const std::vector<std::unique_ptr<Cart>>& carts, sf::Time dt) {
+    if (slots.size() != carts.size()) slots.resize(carts.size());
+    reserved.clear(); order.clear(); stats = {};
+    const float ts = (float)map.tileSize();
+    // pass 1: holds that are already committed (current tile, tile being entered, junction paths)
+    for (uint32_t i = 0; i < carts.size(); ++i) {
+        const Cart &c = *carts[i]; Slot &s = slots[i];
+        if (s.cart != &c) s = Slot{}, s.cart = &c; // list changed: start this slot fresh
+        sf::Vector2f p = c.worldPosition();
+        sf::Vector2u at{ (unsigned)std::max(0.f, p.x / ts), (unsigned)std::max(0.f, p.y / ts) };
+        bool centred = c.atTileCenter();
+        if (centred || !s.hasFrom) { s.from = at; s.hasFrom = true; }
+        if (!reserve(s.from, i)) ++stats.conflicts;
+        if (centred) { // drop the part of the junction path already driven
+            auto reached = std::find(s.promised.begin(), s.promised.end(), at);
+            if (reached != s.promised.end()) s.promised.erase(s.promised.begin(), reached + 1);
+        }
+        for (auto t : s.promised) if (!reserve(t, i)) ++stats.conflicts;
+        sf::Vector2u next;
+        if (!c.nextTile(next)) { s.sig = Signal::Green; continue; }
+        if (!centred) { if (!reserve(next, i)) ++stats.conflicts; s.sig = Signal::Green; continue; } // mid-move: keep going
+        s.wantAhead = 0;
+        if (next == s.from) { // still targeting its own tile: the cart will step on to the waypoint after it
+            if (!c.routeAhead(1, next) || next == s.from) { s.sig = Signal::Green; continue; }
+            s.wantAhead = 1;
+        }
+        order.push_back(i);
+    }
+    // pass 2: carts waiting at a tile centre ask for their next tile, longest wait first
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){ return slots[a].waited > slots[b].waited; });
+    for (uint32_t i : order) {
+        const Cart &c = *carts[i]; Slot &s = slots[i];
+        sf::Vector2u next; c.routeAhead(s.wantAhead, next);
+        if (!junction(next) || !s.promised.empty()) { s.sig = reserve(next, i) ? Signal::Green : Signal::Red; continue; }
+        junctionPath(c, s.wantAhead, path);
+        bool free = std::all_of(path.begin(), path.end(), [&](sf::Vector2u t){ return isFree(t, i); });
+        if (!free) { s.sig = Signal::Yield; continue; }
+        for (auto t : path) reserve(t, i);
+        s.promised = path;
+        s.sig = Signal::Green;
+    }
+    for (uint32_t i = 0; i < carts.size(); ++i) {
+        Slot &s = slots[i];
+        carts[i]->setHold(s.sig != Signal::Green);
+        s.waited = s.sig == Signal::Green ? 0.f : s.waited + dt.asSeconds();
+        if (s.sig == Signal::Green) ++stats.green; else if (s.sig == Signal::Red) ++stats.red; else ++stats.yield;
+    }
+}
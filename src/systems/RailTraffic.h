@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+class TileMap;
+class Cart;
+
+// Block signaling for carts (docs/features/rails.md): one batched pass per tick, before carts move,
+// hands out per-tile reservations and holds every cart that may not advance.
+//  - A cart travelling between two tiles holds both; a cart centred on a tile holds that tile.
+//  - GREEN: the next tile is free (or already ours), so it is reserved and the cart moves.
+//  - RED: the next tile is held by another cart.
+//  - YIELD: the next tile is a junction (3+ links). The cart enters only if its whole route through the
+//    junction block is free: every tile up to the first plain tile with ClearAhead plain tiles after it.
+//    Those tiles stay reserved until the cart reaches them, so no cart ever waits inside a junction or
+//    on the short links between close junctions (where crossing flows would gridlock).
+// Waiting carts are served first (longest wait, then cart order), so the outcome is deterministic.
+class RailTraffic {
+public:
+    enum class Signal : uint8_t { Green, Red, Yield };
+    struct Stats { unsigned green = 0, red = 0, yield = 0, conflicts = 0; }; // conflicts: overlapping committed holds
+
+    explicit RailTraffic(const TileMap& map) : map(map) {}
+    void update(const std::vector<std::unique_ptr<Cart>>& carts, sf::Time dt);
+    Signal signal(size_t cartIndex) const { return cartIndex < slots.size() ? slots[cartIndex].sig : Signal::Green; }
+    const Stats& lastStats() const { return stats; }
+    size_t reservedTiles() const { return reserved.size(); }
+
+private:
+    static constexpr unsigned ClearAhead = 3; // plain tiles needed past a junction block to stop safely
+    static constexpr unsigned MaxBlock = 32;  // longest junction path reserved in one go
+    struct Slot {
+        const Cart* cart = nullptr;
+        sf::Vector2u from;                  // tile the cart last sat centred on
+        std::vector<sf::Vector2u> promised; // junction path still ahead of the cart, in route order
+        size_t wantAhead = 0;               // route offset of the tile requested this pass
+        bool hasFrom = false;
+        float waited = 0.f;                 // seconds spent held (priority for the next pass)
+        Signal sig = Signal::Green;
+    };
+    uint32_t key(sf::Vector2u t) const;
+    bool junction(sf::Vector2u t) const;
+    bool reserve(sf::Vector2u t, uint32_t slot); // false when another cart holds t
+    bool isFree(sf::Vector2u t, uint32_t slot) const;
+    bool junctionPath(const Cart& c, size_t ahead, std::vector<sf::Vector2u>& out) const; // tiles to reserve from route offset `ahead`
+    const TileMap& map;
+    std::vector<Slot> slots; // parallel to the cart list
+    std::unordered_map<uint32_t, uint32_t> reserved; // tile key -> slot, rebuilt every pass
+    std::vector<uint32_t> order; // requesting slots, sorted by priority
+    std::vector<sf::Vector2u> path; // scratch for junction paths
+    Stats stats;
+};
@@ -3,8 +3,6 @@
 #include <fstream>
 #include "../input/InputManager.h"
 
-extern nlohmann::json* g_getTunablesJson();
-
 void SaveCustomBindings(const InputManager& input, const std::string& path) {
     nlohmann::json j; nlohmann::json amap = nlohmann::json::object();
     for (auto &kv : input.bindings()) {
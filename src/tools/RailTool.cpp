@@ -18,19 +18,8 @@ void RailTool::update(const sf::Vector2f& worldPos, bool click) {
             map.setTile(hoverTile.x, hoverTile.y, TileMap::Empty);
         } else if (!map.isTileSolid(hoverTile.x, hoverTile.y)) {
             // enforce connectivity: unless this is the first rail overall, require adjacency to an existing rail
-            bool anyRail = false;
-            for (unsigned y=0; y<map.height() && !anyRail; ++y)
-                for (unsigned x=0; x<map.width() && !anyRail; ++x)
-                    if (map.isTileRail(x,y)) anyRail = true;
-            bool adjacent = false;
-            if (anyRail) {
-                unsigned tx = hoverTile.x, ty = hoverTile.y;
-                if (tx>0 && map.isTileRail(tx-1,ty)) adjacent = true;
-                if (tx+1<map.width() && map.isTileRail(tx+1,ty)) adjacent = true;
-                if (ty>0 && map.isTileRail(tx,ty-1)) adjacent = true;
-                if (ty+1<map.height() && map.isTileRail(tx,ty+1)) adjacent = true;
-            }
-            if (!anyRail || adjacent) {
+            const RailNetwork& net = map.rails();
+            if (net.empty() || net.adjacent(hoverTile.x, hoverTile.y)) {
                 map.setTile(hoverTile.x, hoverTile.y, TileMap::Rail);
             } else {
                 std::cerr << "Cannot place rail: must connect to existing rail network.\n";
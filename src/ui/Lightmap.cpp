@@ -0,0 +1,58 @@
+#include "Lightmap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace { constexpr unsigned FalloffSize = 128; }
+
+void Lightmap::bakeFalloff() {
+    // white at the centre fading to black at the rim; smoothstep-shaped so the edge doesn't band
+    sf::Image img({FalloffSize, FalloffSize}, sf::Color::Black);
+    float c = (FalloffSize - 1) * 0.5f;
+    for (unsigned y = 0; y < FalloffSize; ++y)
+        for (unsigned x = 0; x < FalloffSize; ++x) {
+            float d = std::sqrt((x - c) * (x - c) + (y - c) * (y - c)) / c;
+            float u = std::clamp(1.f - d, 0.f, 1.f); u = u * u * (3.f - 2.f * u);
+            auto v = (uint8_t)std::lround(u * 255.f);
+            img.setPixel({x, y}, sf::Color(v, v, v));
+        }
+    falloffBaked = falloff.loadFromImage(img);
+    falloff.setSmooth(true);
+}
+
+void Lightmap::draw(sf::RenderTarget& target, const sf::View& worldView, sf::Color ambient,
+                    const std::vector<sf::Vector2f>& lamps, float lampRadius, sf::Color lampColor) {
+    if (!falloffBaked) bakeFalloff();
+    sf::Vector2u ts = target.getSize();
+    sf::Vector2u want{std::max(1u, (ts.x + downscale - 1) / downscale), std::max(1u, (ts.y + downscale - 1) / downscale)};
+    if (want != size) {
+        if (!lightmap.resize(want)) return;
+        lightmap.setSmooth(true); size = want;
+    }
+    // lamps: one quad each, culled against the view rect grown by the radius
+    sf::Vector2f vc = worldView.getCenter(), vh = worldView.getSize() * 0.5f;
+    float fs = (float)FalloffSize;
+    quads.clear(); lampsDrawn = 0;
+    for (const auto &lp : lamps) {
+        if (std::abs(lp.x - vc.x) > vh.x + lampRadius || std::abs(lp.y - vc.y) > vh.y + lampRadius) continue;
+        sf::Vector2f a{lp.x - lampRadius, lp.y - lampRadius}, b{lp.x + lampRadius, lp.y + lampRadius};
+        sf::Vertex v[4] = {{a, lampColor, {0.f, 0.f}}, {{b.x, a.y}, lampColor, {fs, 0.f}},
+                           {b, lampColor, {fs, fs}}, {{a.x, b.y}, lampColor, {0.f, fs}}};
+        quads.append(v[0]); quads.append(v[1]); quads.append(v[2]);
+        quads.append(v[0]); quads.append(v[2]); quads.append(v[3]);
+        ++lampsDrawn;
+    }
+    lightmap.setView(worldView);
+    lightmap.clear(ambient);
+    if (lampsDrawn) {
+        sf::RenderStates rs(sf::BlendAdd); rs.texture = &falloff;
+        lightmap.draw(quads, rs);
+    }
+    lightmap.display();
+    // composite in screen space: the lightmap covers the whole target
+    sf::View prev = target.getView();
+    target.setView(target.getDefaultView());
+    sf::Sprite sprite(lightmap.getTexture());
+    sprite.setScale({(float)ts.x / size.x, (float)ts.y / size.y});
+    target.draw(sprite, sf::RenderStates(sf::BlendMultiply));
+    target.setView(prev);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Day/night lighting as a low-resolution lightmap: cleared to the ambient color, every lamp inside
+// the view adds one quad textured with a baked radial falloff (all lamps in a single additive draw),
+// then the lightmap is multiplied over the frame once. Cost is one fill + one batched draw no matter
+// how many lamps there are.
+class Lightmap {
+public:
+    void setDownscale(unsigned d) { downscale = d < 1 ? 1 : d; } // screen pixels per lightmap texel
+    void draw(sf::RenderTarget& target, const sf::View& worldView, sf::Color ambient,
+              const std::vector<sf::Vector2f>& lamps, float lampRadius, sf::Color lampColor);
+    size_t lastLampCount() const { return lampsDrawn; }
+
+private:
+    void bakeFalloff();
+    unsigned downscale = 4;
+    sf::RenderTexture lightmap;
+    sf::Vector2u size{0, 0};
+    sf::Texture falloff; bool falloffBaked = false;
+    sf::VertexArray quads{sf::PrimitiveType::Triangles};
+    size_t lampsDrawn = 0;
+};
@@ -0,0 +1,51 @@
+#include "Minimap.h"
+#include "../world/TileMap.h"
+#include <algorithm>
+#include <cstring>
+
+sf::Color Minimap::cellColor(const TileMap& map, unsigned tx, unsigned ty) {
+    if (!map.isExplored(tx,ty)) return sf::Color::Transparent;
+    switch (map.getTile(tx,ty)) {
+        case TileMap::Empty: return sf::Color(70,110,80);
+        case TileMap::Solid: return sf::Color(50,50,55);
+        case TileMap::Plantable: return sf::Color(110,85,40);
+        case TileMap::Rail: return sf::Color(160,140,80);
+    }
+    return sf::Color::Transparent;
+}
+
+void Minimap::rebuild(const TileMap& map) {
+    size = {map.width(), map.height()};
+    image.resize(size, sf::Color::Transparent);
+    for (unsigned ty = 0; ty < size.y; ++ty)
+        for (unsigned tx = 0; tx < size.x; ++tx) image.setPixel({tx,ty}, cellColor(map, tx, ty));
+    if (texture.getSize() != size && !texture.resize(size)) return;
+    texture.update(image);
+    ++rebuildCount;
+}
+
+void Minimap::sync(TileMap& map) {
+    bool all = map.drainCellChanges(changes);
+    if (all || size != sf::Vector2u(map.width(), map.height())) { rebuild(map); return; }
+    if (changes.empty()) return;
+    unsigned x0 = size.x, y0 = size.y, x1 = 0, y1 = 0;
+    for (uint32_t i : changes) {
+        unsigned x = i % size.x, y = i / size.x;
+        image.setPixel({x,y}, cellColor(map, x, y));
+        x0 = std::min(x0, x); y0 = std::min(y0, y); x1 = std::max(x1, x); y1 = std::max(y1, y);
+    }
+    // one upload of the dirty box
+    unsigned bw = x1 - x0 + 1, bh = y1 - y0 + 1;
+    staging.resize(size_t(bw) * bh * 4);
+    const uint8_t* px = image.getPixelsPtr();
+    for (unsigned y = 0; y < bh; ++y) std::memcpy(&staging[size_t(y) * bw * 4], px + (size_t(y0 + y) * size.x + x0) * 4, size_t(bw) * 4);
+    texture.update(staging.data(), {bw, bh}, {x0, y0});
+}
+
+void Minimap::draw(sf::RenderTarget& target, sf::Vector2f origin, float tilePixels) const {
+    if (size.x == 0) return;
+    sf::Sprite sprite(texture);
+    sprite.setPosition(origin);
+    sprite.setScale({tilePixels, tilePixels});
+    target.draw(sprite);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+class TileMap;
+
+// Minimap baked into an image/texture at one pixel per tile (unexplored cells transparent), drawn as a
+// single scaled sprite. sync() pulls the map's cell change journal and re-uploads only the bounding box
+// of changed cells; a full rebuild happens on first use, map resize/load, or bulk edits.
+class Minimap {
+public:
+    void sync(TileMap& map);
+    void draw(sf::RenderTarget& target, sf::Vector2f origin, float tilePixels) const;
+    unsigned fullRebuilds() const { return rebuildCount; }
+
+private:
+    static sf::Color cellColor(const TileMap& map, unsigned tx, unsigned ty);
+    void rebuild(const TileMap& map);
+    sf::Image image;
+    sf::Texture texture;
+    sf::Vector2u size{0, 0};
+    std::vector<uint32_t> changes; // drained cell indices (x + y*w)
+    std::vector<uint8_t> staging;  // RGBA rows of the dirty box
+    unsigned rebuildCount = 0;
+};
@@ -0,0 +1,66 @@
+#include "FlowField.h"
+#include "TileMap.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+// neighbour order: 4 straight then 4 diagonal, opposite directions paired so k^1 reverses k
+static const int kDx[8] = {1,-1,0,0, 1,-1,1,-1};
+static const int kDy[8] = {0,0,1,-1, 1,-1,-1,1};
+static const uint32_t kStep[8] = {10,10,10,10, 14,14,14,14};
+
+void FlowField::setGoal(const sf::Vector2f& worldPos) {
+    float ts = float(map.tileSize());
+    sf::Vector2i g{int(std::floor(worldPos.x / ts)), int(std::floor(worldPos.y / ts))};
+    if (g != goal) { goal = g; stale = true; }
+}
+
+bool FlowField::update() {
+    if (!stale && builtVersion == map.solidVersion()) return false;
+    stale = false; builtVersion = map.solidVersion(); ++rebuildCount;
+    int W = int(map.width()), H = int(map.height());
+    x0 = std::max(0, goal.x - int(radius)); y0 = std::max(0, goal.y - int(radius));
+    int x1 = std::min(W, goal.x + int(radius) + 1), y1 = std::min(H, goal.y + int(radius) + 1);
+    fw = unsigned(std::max(0, x1 - x0)); fh = unsigned(std::max(0, y1 - y0));
+    cost.assign(size_t(fw) * fh, Unreached);
+    next.assign(size_t(fw) * fh, -1);
+    int gi = cellIndex(goal.x, goal.y);
+    if (gi < 0 || map.isTileSolid(goal.x, goal.y)) return true;
+    // Dijkstra from the goal; diagonals only when both straight neighbours are open (no corner cutting)
+    using Node = std::pair<uint32_t, int>;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
+    cost[gi] = 0; open.push({0, gi});
+    while (!open.empty()) {
+        auto [c, i] = open.top(); open.pop();
+        if (c != cost[i]) continue;
+        int tx = x0 + i % int(fw), ty = y0 + i / int(fw);
+        for (int k = 0; k < 8; ++k) {
+            int nx = tx + kDx[k], ny = ty + kDy[k];
+            int ni = cellIndex(nx, ny);
+            if (ni < 0 || map.isTileSolid(nx, ny)) continue;
+            if (k >= 4 && (map.isTileSolid(tx + kDx[k], ty) || map.isTileSolid(tx, ty + kDy[k]))) continue;
+            uint32_t nc = c + kStep[k];
+            if (nc < cost[ni]) { cost[ni] = nc; next[ni] = int8_t(k ^ 1); open.push({nc, ni}); }
+        }
+    }
+    return true;
+}
+
+sf::Vector2f FlowField::direction(const sf::Vector2f& worldPos) const {
+    float ts = float(map.tileSize());
+    int tx = int(std::floor(worldPos.x / ts)), ty = int(std::floor(worldPos.y / ts));
+    int i = cellIndex(tx, ty);
+    if (i < 0 || next[i] < 0) return {0.f, 0.f};
+    // head for the centre of the next tile so wide bodies line up with gaps
+    int k = next[i];
+    sf::Vector2f target{(tx + kDx[k] + 0.5f) * ts, (ty + kDy[k] + 0.5f) * ts};
+    sf::Vector2f d = target - worldPos;
+    float len = std::sqrt(d.x*d.x + d.y*d.y);
+    return len > 0.f ? d / len : sf::Vector2f{0.f, 0.f};
+}
+
+bool FlowField::reachable(const sf::Vector2f& worldPos) const {
+    float ts = float(map.tileSize());
+    int i = cellIndex(int(std::floor(worldPos.x / ts)), int(std::floor(worldPos.y / ts)));
+    return i >= 0 && cost[i] != Unreached;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+class TileMap;
+
+// Dijkstra integration field toward one goal tile (the player), shared by every chaser.
+// Covers a square window of +-radius tiles around the goal so cost stays bounded on huge maps;
+// rebuilt only when the goal changes tile or the map's solidity version moves.
+class FlowField {
+public:
+    explicit FlowField(const TileMap& map, unsigned radius = 64) : map(map), radius(radius) {}
+    void setRadius(unsigned r) { if (r != radius) { radius = r; stale = true; } }
+    void setGoal(const sf::Vector2f& worldPos); // call every tick; cheap unless the goal tile changed
+    bool update(); // recompute if stale; returns true when a rebuild happened
+
+    // O(1) steering: unit vector from worldPos toward the next tile on the shortest path.
+    // Returns {0,0} at the goal tile or outside the field (caller falls back to direct chase).
+    sf::Vector2f direction(const sf::Vector2f& worldPos) const;
+    bool reachable(const sf::Vector2f& worldPos) const; // inside the window with a path to the goal
+    unsigned rebuilds() const { return rebuildCount; }
+
+private:
+    static constexpr uint32_t Unreached = UINT32_MAX;
+    int cellIndex(int tx, int ty) const { return (tx >= x0 && ty >= y0 && tx < x0 + int(fw) && ty < y0 + int(fh)) ? (tx - x0) + (ty - y0) * int(fw) : -1; }
+    const TileMap& map;
+    unsigned radius;
+    sf::Vector2i goal{-1,-1};
+    uint32_t builtVersion = 0;
+    bool stale = true;
+    int x0 = 0, y0 = 0; unsigned fw = 0, fh = 0; // window origin/size in tiles
+    std::vector<uint32_t> cost; // integrated cost to goal (10 per straight step, 14 per diagonal)
+    std::vector<int8_t> next;   // best neighbour (0..7, see offsets in cpp) or -1
+    unsigned rebuildCount = 0;
+};
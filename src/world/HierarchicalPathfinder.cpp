@@ -0,0 +1,242 @@
+#include "HierarchicalPathfinder.h"
+#include "TileMap.h"
+#include <algorithm>
+#include <array>
+#include <queue>
+
+static const int kDx[8] = {1,-1,0,0, 1,-1,1,-1};
+static const int kDy[8] = {0,0,1,-1, 1,-1,-1,1};
+static const uint32_t kStep[8] = {10,10,10,10, 14,14,14,14};
+static constexpr uint32_t kInf = UINT32_MAX;
+static constexpr int kLongRun = 6; // runs at least this long get a portal at each end instead of one in the middle
+
+static uint32_t octile(sf::Vector2i a, sf::Vector2i b) {
+    int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+    return uint32_t(10 * std::max(dx, dy) + 4 * std::min(dx, dy));
+}
+
+sf::IntRect HierarchicalPathfinder::clusterRect(unsigned c) const {
+    int cs = int(TileMap::ChunkTiles);
+    int x0 = int(c % cols) * cs, y0 = int(c / cols) * cs;
+    return sf::IntRect({x0, y0}, {std::min(cs, int(map.width()) - x0), std::min(cs, int(map.height()) - y0)});
+}
+
+unsigned HierarchicalPathfinder::clusterOf(sf::Vector2i t) const {
+    return unsigned(t.x) / TileMap::ChunkTiles + (unsigned(t.y) / TileMap::ChunkTiles) * cols;
+}
+
+unsigned HierarchicalPathfinder::addNode(sf::Vector2i tile, int border) {
+    unsigned id;
+    if (!freeNodes.empty()) { id = freeNodes.back(); freeNodes.pop_back(); }
+    else { id = unsigned(nodes.size()); nodes.emplace_back(); }
+    Node &n = nodes[id];
+    n.tile = tile; n.cluster = clusterOf(tile); n.border = border; n.edges.clear();
+    clusterNodes[n.cluster].push_back(id);
+    return id;
+}
+
+void HierarchicalPathfinder::buildBorder(int border) {
+    unsigned c = unsigned(border) / 2; bool east = (border % 2) == 0;
+    unsigned cx = c % cols, cy = c / cols;
+    if (east ? cx + 1 >= cols : cy + 1 >= rows) return;
+    sf::IntRect r = clusterRect(c);
+    // walk the shared edge; a and b are the facing tiles in this cluster and the neighbour
+    int len = east ? r.size.y : r.size.x;
+    auto tileA = [&](int i){ return east ? sf::Vector2i{r.position.x + r.size.x - 1, r.position.y + i} : sf::Vector2i{r.position.x + i, r.position.y + r.size.y - 1}; };
+    auto tileB = [&](int i){ sf::Vector2i a = tileA(i); return east ? sf::Vector2i{a.x + 1, a.y} : sf::Vector2i{a.x, a.y + 1}; };
+    auto open = [&](int i){ sf::Vector2i a = tileA(i), b = tileB(i); return !map.isTileSolid(a.x, a.y) && !map.isTileSolid(b.x, b.y); };
+    auto link = [&](int i){
+        unsigned na = addNode(tileA(i), border), nb = addNode(tileB(i), border);
+        nodes[na].partner = nb; nodes[nb].partner = na;
+        nodes[na].edges.push_back({nb, 10}); nodes[nb].edges.push_back({na, 10});
+    };
+    for (int i = 0; i < len;) {
+        if (!open(i)) { ++i; continue; }
+        int start = i; while (i < len && open(i)) ++i;
+        int runLen = i - start;
+        if (runLen >= kLongRun) { link(start); link(i - 1); }
+        else link(start + runLen / 2);
+    }
+}
+
+void HierarchicalPathfinder::dropBorder(int border) {
+    unsigned c = unsigned(border) / 2; bool east = (border % 2) == 0;
+    unsigned other = east ? c + 1 : c + cols;
+    for (unsigned cl : {c, other}) {
+        if (cl >= clusterNodes.size()) continue;
+        auto &list = clusterNodes[cl];
+        list.erase(std::remove_if(list.begin(), list.end(), [&](unsigned id){
+            if (nodes[id].border != border) return false;
+            nodes[id].edges.clear(); freeNodes.push_back(id);
+            return true;
+        }), list.end());
+    }
+}
+
+void HierarchicalPathfinder::searchRect(const sf::IntRect& rect, sf::Vector2i src, const sf::Vector2i* target) {
+    const int rw = rect.size.x, rh = rect.size.y;
+    size_t n = size_t(rw) * rh;
+    if (!(rect == scratchRect) || scratchVersion != map.solidVersion()) {
+        scratchPass.resize(n);
+        for (int y = 0; y < rh; ++y) for (int x = 0; x < rw; ++x)
+            scratchPass[x + y*rw] = !map.isTileSolid(rect.position.x + x, rect.position.y + y);
+        scratchRect = rect; scratchVersion = map.solidVersion();
+    }
+    scratch.assign(n, kInf); scratchParent.assign(n, -1);
+    int s = (src.x - rect.position.x) + (src.y - rect.position.y) * rw;
+    int goal = (target && rect.contains(*target)) ? (target->x - rect.position.x) + (target->y - rect.position.y) * rw : -1;
+    // step costs are 10/14, so 16 rotating buckets hold every pending cost
+    std::array<std::vector<int>, 16> buckets;
+    size_t pending = 1; scratch[s] = 0; buckets[0].push_back(s);
+    for (uint32_t cur = 0; pending > 0; ++cur) {
+        auto &b = buckets[cur % 16];
+        while (!b.empty()) {
+            int i = b.back(); b.pop_back(); --pending;
+            if (scratch[i] != cur) continue;
+            if (i == goal) return;
+            int x = i % rw, y = i / rw;
+            for (int k = 0; k < 8; ++k) {
+                int nx = x + kDx[k], ny = y + kDy[k];
+                if (nx < 0 || ny < 0 || nx >= rw || ny >= rh || !scratchPass[nx + ny*rw]) continue;
+                if (k >= 4 && (!scratchPass[nx + y*rw] || !scratchPass[x + ny*rw])) continue; // no corner cutting
+                int ni = nx + ny*rw; uint32_t nc = cur + kStep[k];
+                if (nc < scratch[ni]) { scratch[ni] = nc; scratchParent[ni] = i; buckets[nc % 16].push_back(ni); ++pending; }
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::buildIntraEdges(unsigned cluster) {
+    auto &list = clusterNodes[cluster];
+    // keep only the portal crossing, then add fresh intra costs
+    for (unsigned id : list) nodes[id].edges.assign(1, Edge{nodes[id].partner, 10});
+    sf::IntRect rect = clusterRect(cluster);
+    for (size_t a = 0; a < list.size(); ++a) {
+        searchRect(rect, nodes[list[a]].tile, nullptr);
+        for (size_t b = 0; b < list.size(); ++b) {
+            if (a == b) continue;
+            uint32_t c = scratchCost(rect, nodes[list[b]].tile);
+            if (c != kInf) nodes[list[a]].edges.push_back({list[b], c});
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildAll() {
+    cols = map.chunkColumns(); rows = map.chunkRowCount();
+    nodes.clear(); freeNodes.clear();
+    clusterNodes.assign(size_t(cols) * rows, {});
+    clusterBuilt.assign(size_t(cols) * rows, 0);
+    for (unsigned c = 0; c < cols * rows; ++c) { buildBorder(int(2*c)); buildBorder(int(2*c + 1)); }
+    for (unsigned c = 0; c < cols * rows; ++c) { buildIntraEdges(c); clusterBuilt[c] = map.chunkSolidVersion(c % cols, c / cols); }
+}
+
+void HierarchicalPathfinder::repairCluster(unsigned c) {
+    unsigned cx = c % cols, cy = c / cols;
+    // the four borders of c: its own east/south plus the west neighbour's east and the north neighbour's south
+    std::vector<int> borders = {int(2*c), int(2*c + 1)};
+    if (cx > 0) borders.push_back(int(2*(c - 1)));
+    if (cy > 0) borders.push_back(int(2*(c - cols) + 1));
+    for (int b : borders) dropBorder(b);
+    for (int b : borders) buildBorder(b);
+    buildIntraEdges(c);
+    if (cx > 0) buildIntraEdges(c - 1);
+    if (cx + 1 < cols) buildIntraEdges(c + 1);
+    if (cy > 0) buildIntraEdges(c - cols);
+    if (cy + 1 < rows) buildIntraEdges(c + cols);
+    clusterBuilt[c] = map.chunkSolidVersion(cx, cy);
+    ++repairCount;
+}
+
+void HierarchicalPathfinder::sync() {
+    uint32_t version = map.solidVersion();
+    if (syncedReset != map.solidResetVersion() || cols != map.chunkColumns() || rows != map.chunkRowCount()) {
+        rebuildAll();
+    } else if (version != syncedVersion) {
+        // collect first: repairing one cluster rebuilds its neighbours' intra edges but not their borders
+        std::vector<unsigned> dirty;
+        for (unsigned c = 0; c < cols * rows; ++c)
+            if (map.chunkSolidVersion(c % cols, c / cols) > clusterBuilt[c]) dirty.push_back(c);
+        for (unsigned c : dirty) repairCluster(c);
+    }
+    syncedVersion = version; syncedReset = map.solidResetVersion();
+}
+
+void HierarchicalPathfinder::appendLocalPath(const sf::IntRect& rect, sf::Vector2i from, sf::Vector2i to, std::vector<sf::Vector2i>& out) {
+    searchRect(rect, from, &to);
+    std::vector<sf::Vector2i> seg;
+    int i = (to.x - rect.position.x) + (to.y - rect.position.y) * rect.size.x;
+    for (; i >= 0; i = scratchParent[i]) seg.push_back({rect.position.x + i % rect.size.x, rect.position.y + i / rect.size.x});
+    std::reverse(seg.begin(), seg.end());
+    // skip the first tile when it repeats the end of what is already there
+    out.insert(out.end(), seg.begin() + (!out.empty() && out.back() == seg.front() ? 1 : 0), seg.end());
+}
+
+std::vector<sf::Vector2i> HierarchicalPathfinder::findPath(sf::Vector2i from, sf::Vector2i to) {
+    std::vector<sf::Vector2i> path;
+    if (map.isTileSolid(from.x, from.y) || map.isTileSolid(to.x, to.y) || from.x < 0 || from.y < 0 || to.x < 0 || to.y < 0) return path;
+    sync();
+    unsigned cs = clusterOf(from), cg = clusterOf(to);
+    if (cs == cg) {
+        // same cluster: a local search is usually enough
+        sf::IntRect rect = clusterRect(cs);
+        searchRect(rect, from, &to);
+        if (scratchCost(rect, to) != kInf) { appendLocalPath(rect, from, to, path); return path; }
+    }
+    // abstract search state sized to the node table; stamps avoid clearing it per query
+    size_t nn = nodes.size();
+    if (gCost.size() < nn) { gCost.resize(nn); searchStamp.resize(nn, 0); parentNode.resize(nn); }
+    const uint32_t openStamp = ++searchId;
+    // costs from goal to its cluster's portals, then seed the open list from the start cluster's portals
+    const unsigned none = UINT32_MAX;
+    sf::IntRect rs = clusterRect(cs), rg = clusterRect(cg);
+    searchRect(rg, to, nullptr);
+    std::vector<std::pair<unsigned, uint32_t>> goalSide;
+    for (unsigned id : clusterNodes[cg]) { uint32_t c = scratchCost(rg, nodes[id].tile); if (c != kInf) goalSide.push_back({id, c}); }
+    if (goalSide.empty()) return path;
+    // open list keyed by f, ties broken toward larger g (deeper nodes) to cut plateau expansions
+    using QNode = std::pair<uint64_t, unsigned>;
+    auto key = [](uint32_t f, uint32_t g){ return (uint64_t(f) << 32) | (UINT32_MAX - g); };
+    std::priority_queue<QNode, std::vector<QNode>, std::greater<QNode>> open;
+    searchRect(rs, from, nullptr);
+    for (unsigned id : clusterNodes[cs]) {
+        uint32_t c = scratchCost(rs, nodes[id].tile);
+        if (c == kInf) continue;
+        searchStamp[id] = openStamp; gCost[id] = c; parentNode[id] = none;
+        open.push({key(c + octile(nodes[id].tile, to), c), id});
+    }
+    auto goalCostOf = [&](unsigned id) -> uint32_t { // a handful of portals per cluster: linear scan
+        for (auto &gs : goalSide) if (gs.first == id) return gs.second;
+        return kInf;
+    };
+
+    // abstract A*; the goal is reached through any goal-cluster portal plus its local cost
+    uint32_t best = kInf; unsigned bestNode = none;
+    while (!open.empty()) {
+        auto [k, id] = open.top(); open.pop();
+        uint32_t f = uint32_t(k >> 32), gc = gCost[id];
+        if (f >= best) break;
+        if (UINT32_MAX - uint32_t(k) != gc) continue; // stale entry
+        if (nodes[id].cluster == cg) { uint32_t gcost = goalCostOf(id); if (gcost != kInf && gc + gcost < best) { best = gc + gcost; bestNode = id; } }
+        for (const Edge &e : nodes[id].edges) {
+            uint32_t nc = gc + e.cost;
+            if (searchStamp[e.to] == openStamp && gCost[e.to] <= nc) continue;
+            searchStamp[e.to] = openStamp; gCost[e.to] = nc; parentNode[e.to] = id;
+            open.push({key(nc + octile(nodes[e.to].tile, to), nc), e.to});
+        }
+    }
+    if (bestNode == none) return path;
+
+    // refine: local searches inside each cluster, single steps across portals
+    std::vector<unsigned> chain;
+    for (unsigned id = bestNode; id != none; id = parentNode[id]) chain.push_back(id);
+    std::reverse(chain.begin(), chain.end());
+    sf::Vector2i cur = from; unsigned curCluster = cs;
+    for (unsigned id : chain) {
+        const Node &n = nodes[id];
+        if (n.cluster == curCluster) appendLocalPath(clusterRect(curCluster), cur, n.tile, path);
+        else path.push_back(n.tile); // portal crossing
+        cur = n.tile; curCluster = n.cluster;
+    }
+    appendLocalPath(clusterRect(cg), cur, to, path);
+    return path;
+}
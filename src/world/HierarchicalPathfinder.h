@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+class TileMap;
+
+// HPA* over TileMap: clusters are the map's storage chunks, portals sit on open runs along each
+// cluster border, and the abstract graph (portal nodes + cached intra-cluster costs) is kept in
+// sync lazily: chunks whose solidity changed since the last query have only their four borders
+// and the clusters touching them rebuilt. Moves are 8-way without corner cutting (10 / 14 cost).
+class HierarchicalPathfinder {
+public:
+    explicit HierarchicalPathfinder(const TileMap& map) : map(map) {}
+
+    // tile path from -> to inclusive; empty when either end is blocked or no path exists
+    std::vector<sf::Vector2i> findPath(sf::Vector2i from, sf::Vector2i to);
+    void sync(); // bring the abstract graph up to date with the map (findPath calls this)
+
+    size_t nodeCount() const { return nodes.size() - freeNodes.size(); }
+    unsigned clusterRepairs() const { return repairCount; }
+
+private:
+    struct Edge { unsigned to; uint32_t cost; };
+    // edges[0] is always the portal crossing to `partner`; the rest are cached intra-cluster costs
+    struct Node { sf::Vector2i tile; unsigned cluster = 0; int border = -1; unsigned partner = 0; std::vector<Edge> edges; };
+    // border ids: 2*cluster for the east border, 2*cluster+1 for the south border
+    void rebuildAll();
+    void repairCluster(unsigned cluster);
+    void buildBorder(int border);
+    void dropBorder(int border);
+    void buildIntraEdges(unsigned cluster);
+    unsigned addNode(sf::Vector2i tile, int border);
+    sf::IntRect clusterRect(unsigned cluster) const;
+    unsigned clusterOf(sf::Vector2i t) const;
+    // Dijkstra (bucket queue) confined to rect from src; stops early once `target` (if inside) is settled.
+    // Leaves costs/parents in the scratch arrays indexed relative to rect; passability is cached per rect.
+    void searchRect(const sf::IntRect& rect, sf::Vector2i src, const sf::Vector2i* target);
+    uint32_t scratchCost(const sf::IntRect& rect, sf::Vector2i t) const { return scratch[(t.x - rect.position.x) + (t.y - rect.position.y) * rect.size.x]; }
+    void appendLocalPath(const sf::IntRect& rect, sf::Vector2i from, sf::Vector2i to, std::vector<sf::Vector2i>& out);
+
+    const TileMap& map;
+    std::vector<Node> nodes;
+    std::vector<unsigned> freeNodes;
+    std::vector<std::vector<unsigned>> clusterNodes;
+    std::vector<uint32_t> clusterBuilt; // chunk solid version each cluster was built against
+    unsigned cols = 0, rows = 0;
+    uint32_t syncedVersion = 0, syncedReset = UINT32_MAX;
+    std::vector<uint32_t> scratch; std::vector<int> scratchParent; // per-rect search state
+    std::vector<uint8_t> scratchPass; sf::IntRect scratchRect; uint32_t scratchVersion = UINT32_MAX;
+    // abstract search state, indexed by node id; searchStamp marks entries valid for the current query
+    std::vector<uint32_t> gCost, searchStamp; std::vector<unsigned> parentNode;
+    uint32_t searchId = 0;
+    unsigned repairCount = 0;
+};
@@ -0,0 +1,138 @@
+#include "RailNetwork.h"
+#include <utility>
+
+void RailNetwork::reset(unsigned mapWidth) {
+    width = mapWidth;
+    nodeOf.clear(); parent.clear(); liveSize.clear();
+    deadNodes = 0; components = 0; ++ver;
+}
+
+uint32_t RailNetwork::find(uint32_t n) const {
+    uint32_t r = n;
+    while (parent[r] != r) r = parent[r];
+    while (parent[n] != r) { uint32_t next = parent[n]; parent[n] = r; n = next; }
+    return r;
+}
+
+uint32_t RailNetwork::newNode() {
+    uint32_t n = (uint32_t)parent.size();
+    parent.push_back(n); liveSize.push_back(1);
+    return n;
+}
+
+void RailNetwork::unite(uint32_t a, uint32_t b) {
+    a = find(a); b = find(b);
+    if (a == b) return;
+    if (liveSize[a] < liveSize[b]) std::swap(a, b);
+    parent[b] = a; liveSize[a] += liveSize[b];
+    --components;
+}
+
+int RailNetwork::neighbours(uint32_t k, uint32_t out[4]) const {
+    int n = 0; unsigned x = k % width;
+    auto probe = [&](uint32_t nk){ if (nodeOf.count(nk)) out[n++] = nk; };
+    if (k >= width) probe(k - width);  // N
+    if (x + 1 < width) probe(k + 1);   // E
+    probe(k + width);                  // S (rows past the map never hold rails)
+    if (x > 0) probe(k - 1);           // W
+    return n;
+}
+
+bool RailNetwork::adjacent(unsigned tx, unsigned ty) const {
+    uint32_t nb[4];
+    return width && neighbours(key(tx,ty), nb) > 0;
+}
+
+int RailNetwork::component(unsigned tx, unsigned ty) const {
+    auto it = nodeOf.find(key(tx,ty));
+    return it == nodeOf.end() ? -1 : (int)find(it->second);
+}
+
+bool RailNetwork::connected(unsigned ax, unsigned ay, unsigned bx, unsigned by) const {
+    int a = component(ax, ay);
+    return a >= 0 && a == component(bx, by);
+}
+
+size_t RailNetwork::componentSize(unsigned tx, unsigned ty) const {
+    int c = component(tx, ty);
+    return c < 0 ? 0 : liveSize[c];
+}
+
+void RailNetwork::add(unsigned tx, unsigned ty) {
+    if (!width || contains(tx,ty)) return;
+    uint32_t k = key(tx,ty), n = newNode();
+    nodeOf.emplace(k, n);
+    ++components; ++ver;
+    uint32_t nb[4]; int cnt = neighbours(k, nb);
+    for (int i = 0; i < cnt; ++i) unite(n, nodeOf[nb[i]]);
+}
+
+void RailNetwork::remove(unsigned tx, unsigned ty) {
+    auto it = nodeOf.find(key(tx,ty));
+    if (it == nodeOf.end()) return;
+    uint32_t k = it->first, root = find(it->second);
+    nodeOf.erase(it); // the node stays behind as an interior link for the rest of its tree
+    ++deadNodes; ++ver;
+    if (--liveSize[root] == 0) --components;
+    uint32_t nb[4]; int cnt = neighbours(k, nb);
+    if (cnt > 1) splitAround(nb, cnt, root); // a dead end or isolated tile can't disconnect anything
+    if (deadNodes > 1024 && deadNodes > nodeOf.size()) compact();
+}
+
+void RailNetwork::splitAround(const uint32_t* nb, int count, uint32_t root) {
+    // One BFS per former neighbour, advanced one tile each in turn. Searches that meet are merged into a
+    // group; a group whose searches all run dry is a closed piece. Stop once at most one group is still
+    // open: that one (the largest piece) keeps the old root, every closed piece gets fresh nodes.
+    struct Search { std::vector<uint32_t> queue; size_t head = 0; int group; };
+    std::vector<Search> s(count);
+    std::unordered_map<uint32_t, int> owner; // tile key -> search index
+    int group[4];
+    auto groupOf = [&](int i){ while (group[i] != i) i = group[i]; return i; };
+    for (int i = 0; i < count; ++i) { s[i].queue.push_back(nb[i]); owner[nb[i]] = i; group[i] = i; }
+    auto groupOpen = [&](int g){ for (int i = 0; i < count; ++i) if (groupOf(i) == g && s[i].head < s[i].queue.size()) return true; return false; };
+    auto openGroups = [&]{ int n = 0; for (int i = 0; i < count; ++i) if (groupOf(i) == i && groupOpen(i)) ++n; return n; };
+    while (openGroups() > 1) {
+        for (int i = 0; i < count; ++i) {
+            Search &cur = s[i];
+            if (cur.head >= cur.queue.size()) continue;
+            uint32_t k = cur.queue[cur.head++];
+            uint32_t next[4]; int n = neighbours(k, next);
+            for (int j = 0; j < n; ++j) {
+                auto [o, fresh] = owner.emplace(next[j], i);
+                if (fresh) { cur.queue.push_back(next[j]); continue; }
+                int a = groupOf(o->second), b = groupOf(i);
+                if (a != b) group[a] = b; // the two searches flood the same piece
+            }
+        }
+    }
+    // the piece left open (or, if all closed, the largest) keeps the old root
+    auto pieceSize = [&](int g){ size_t n = 0; for (int i = 0; i < count; ++i) if (groupOf(i) == g) n += s[i].queue.size(); return n; };
+    int keep = -1;
+    for (int i = 0; i < count; ++i) {
+        if (groupOf(i) != i) continue;
+        if (groupOpen(i)) { keep = i; break; }
+        if (keep < 0 || pieceSize(i) > pieceSize(keep)) keep = i;
+    }
+    for (int g = 0; g < count; ++g) {
+        if (groupOf(g) != g || g == keep) continue;
+        uint32_t r = newNode(); liveSize[r] = 0;
+        for (int i = 0; i < count; ++i) {
+            if (groupOf(i) != g) continue;
+            for (uint32_t k : s[i].queue) { // old node becomes a tombstone under the old root
+                nodeOf[k] = (uint32_t)parent.size(); parent.push_back(r); liveSize.push_back(0); ++deadNodes;
+            }
+            liveSize[r] += (uint32_t)s[i].queue.size();
+        }
+        liveSize[root] -= liveSize[r];
+        ++components;
+    }
+}
+
+void RailNetwork::compact() {
+    std::vector<uint32_t> keys; keys.reserve(nodeOf.size());
+    for (auto &kv : nodeOf) keys.push_back(kv.first);
+    uint32_t v = ver;
+    reset(width);
+    for (uint32_t k : keys) add(k % width, k / width);
+    ver = v + 1;
+}
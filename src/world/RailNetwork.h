@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Rail tiles as graph nodes (4-neighbour links, same rule as TileMap::railBits) with connected
+// components tracked incrementally: union-find on add; on remove the removed tile's neighbours are
+// flooded in lockstep and only the pieces that actually split off are re-rooted, so the work is
+// bounded by the smaller pieces, not the network. Kept in sync by TileMap::setTile.
+class RailNetwork {
+public:
+    void reset(unsigned mapWidth); // drop everything; tile keys are x + y*mapWidth
+    void add(unsigned tx, unsigned ty);
+    void remove(unsigned tx, unsigned ty);
+
+    bool contains(unsigned tx, unsigned ty) const { return nodeOf.count(key(tx,ty)) != 0; }
+    bool adjacent(unsigned tx, unsigned ty) const; // a rail sits N/E/S/W of the tile (placing one here joins the network)
+    int component(unsigned tx, unsigned ty) const; // -1 when not a rail; ids stay valid until the next add/remove
+    bool connected(unsigned ax, unsigned ay, unsigned bx, unsigned by) const;
+    size_t componentSize(unsigned tx, unsigned ty) const; // rail tiles in the tile's component (0 when not a rail)
+    size_t tileCount() const { return nodeOf.size(); }
+    bool empty() const { return nodeOf.empty(); }
+    unsigned componentCount() const { return components; }
+    uint32_t version() const { return ver; } // bumps on every add/remove (route caches compare it)
+    template<class F> void forEachTile(F&& f) const { for (auto &kv : nodeOf) f(kv.first % width, kv.first / width); }
+
+private:
+    uint32_t key(unsigned tx, unsigned ty) const { return tx + ty * width; }
+    uint32_t find(uint32_t n) const;
+    uint32_t newNode();
+    void unite(uint32_t a, uint32_t b);
+    int neighbours(uint32_t k, uint32_t out[4]) const; // rail neighbour keys of k
+    void splitAround(const uint32_t* nb, int count, uint32_t root);
+    void compact(); // rebuild from the live tiles once removals left too many tombstones
+
+    unsigned width = 0;
+    std::unordered_map<uint32_t, uint32_t> nodeOf; // rail tile key -> union-find node
+    mutable std::vector<uint32_t> parent; // path compression on lookups
+    std::vector<uint32_t> liveSize; // at roots: live rail tiles in the component
+    size_t deadNodes = 0; // nodes of removed or re-rooted tiles, kept as interior links
+    unsigned components = 0;
+    uint32_t ver = 0;
+};
@@ -0,0 +1,51 @@
+#include "RailRouter.h"
+#include "TileMap.h"
+#include <queue>
+#include <algorithm>
+#include <cstdlib>
+
+uint32_t RailRouter::version() const { return map.rails().version(); }
+
+std::shared_ptr<const RailRouter::Route> RailRouter::route(sf::Vector2u from, sf::Vector2u to) {
+    if (cacheVersion != version() || cache.size() >= MaxCached) { cache.clear(); cacheVersion = version(); }
+    uint64_t key = (uint64_t(from.x) << 48) | (uint64_t(from.y) << 32) | (uint64_t(to.x) << 16) | to.y;
+    auto it = cache.find(key);
+    if (it != cache.end()) { ++hitCount; return it->second; }
+    auto r = std::make_shared<const Route>(search(from, to));
+    cache.emplace(key, r);
+    return r;
+}
+
+RailRouter::Route RailRouter::search(sf::Vector2u from, sf::Vector2u to) {
+    if (!map.rails().connected(from.x, from.y, to.x, to.y)) return {};
+    if (from == to) return { from };
+    ++searchCount;
+    const uint32_t w = map.width();
+    auto h = [&](uint32_t k){ return uint32_t(std::abs(int(k % w) - int(to.x)) + std::abs(int(k / w) - int(to.y))); };
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0}; // bit order of railBits: N, E, S, W
+    uint32_t src = from.x + from.y * w, dst = to.x + to.y * w;
+    visited.clear();
+    visited[src] = {0, src};
+    using QNode = std::pair<uint32_t, uint32_t>; // f, tile key
+    std::priority_queue<QNode, std::vector<QNode>, std::greater<QNode>> open;
+    open.push({h(src), src});
+    while (!open.empty()) {
+        auto [f, k] = open.top(); open.pop();
+        uint32_t g = visited[k].g;
+        if (f != g + h(k)) continue; // stale entry
+        if (k == dst) break;
+        uint8_t bits = map.railBits(k % w, k / w);
+        for (int d = 0; d < 4; ++d) {
+            if (!(bits & (1u << d))) continue;
+            uint32_t n = uint32_t(int(k % w) + dx[d]) + uint32_t(int(k / w) + dy[d]) * w;
+            auto [v, fresh] = visited.try_emplace(n, Visit{g + 1, k});
+            if (!fresh) { if (v->second.g <= g + 1) continue; v->second = {g + 1, k}; }
+            open.push({g + 1 + h(n), n});
+        }
+    }
+    Route out;
+    if (!visited.count(dst)) return out; // components said connected, so only a stale railMeta gets here
+    for (uint32_t k = dst; ; k = visited[k].parent) { out.push_back({k % w, k / w}); if (k == src) break; }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+class TileMap;
+
+// Shortest cart routes over the rail graph (railBits links, unit cost per tile), A* with a Manhattan
+// heuristic. Routes are shared between carts through a cache keyed by (from, to) that is dropped as a
+// whole whenever the rail network's version moves; unreachable pairs are rejected in O(α) through the
+// network's connected components and cached as empty routes.
+class RailRouter {
+public:
+    using Route = std::vector<sf::Vector2u>; // rail tiles from -> to inclusive; empty when unreachable
+    explicit RailRouter(const TileMap& map) : map(map) {}
+
+    std::shared_ptr<const Route> route(sf::Vector2u from, sf::Vector2u to);
+    uint32_t version() const; // rail network version the cache is valid for (carts re-plan when it moves)
+
+    size_t cachedRoutes() const { return cache.size(); }
+    unsigned searches() const { return searchCount; }
+    unsigned cacheHits() const { return hitCount; }
+
+private:
+    static constexpr size_t MaxCached = 4096; // cleared wholesale when exceeded
+    Route search(sf::Vector2u from, sf::Vector2u to);
+    const TileMap& map;
+    std::unordered_map<uint64_t, std::shared_ptr<const Route>> cache;
+    uint32_t cacheVersion = UINT32_MAX;
+    struct Visit { uint32_t g; uint32_t parent; };
+    std::unordered_map<uint32_t, Visit> visited; // per-search scratch, keyed by x + y*width
+    unsigned searchCount = 0, hitCount = 0;
+};
@@ -0,0 +1,78 @@
+#include "SoilKernel.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define SOIL_HAVE_SSE2 1
+#include <immintrin.h>
+#endif
+#if defined(SOIL_HAVE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define SOIL_HAVE_AVX2 1
+#endif
+
+// moisture: above target -> max(T, m-down), below -> min(T, m+up); both collapse to max(min(m+up,T), m-down)
+// fertility: below target -> min(T, f+up), else unchanged; collapses to max(f, min(f+up,T))
+static bool soilScalar(float* m, float* f, size_t n, const SoilStep& s) {
+    bool changed = false;
+    for (size_t i = 0; i < n; ++i) changed |= soilStepTile(m[i], f[i], s);
+    return changed;
+}
+
+#ifdef SOIL_HAVE_SSE2
+static bool soilSSE2(float* m, float* f, size_t n, const SoilStep& s) {
+    const __m128 mt = _mm_set1_ps(s.moistureTarget), up = _mm_set1_ps(s.moistureUp), down = _mm_set1_ps(s.moistureDown);
+    const __m128 ft = _mm_set1_ps(s.fertilityTarget), fup = _mm_set1_ps(s.fertilityUp);
+    __m128 below = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 mv = _mm_loadu_ps(m + i);
+        _mm_storeu_ps(m + i, _mm_max_ps(_mm_min_ps(_mm_add_ps(mv, up), mt), _mm_sub_ps(mv, down)));
+        __m128 fv = _mm_loadu_ps(f + i);
+        below = _mm_or_ps(below, _mm_cmplt_ps(fv, ft));
+        _mm_storeu_ps(f + i, _mm_max_ps(fv, _mm_min_ps(_mm_add_ps(fv, fup), ft)));
+    }
+    bool changed = _mm_movemask_ps(below) != 0;
+    return soilScalar(m + i, f + i, n - i, s) || changed;
+}
+#endif
+
+#ifdef SOIL_HAVE_AVX2
+__attribute__((target("avx2")))
+static bool soilAVX2(float* m, float* f, size_t n, const SoilStep& s) {
+    const __m256 mt = _mm256_set1_ps(s.moistureTarget), up = _mm256_set1_ps(s.moistureUp), down = _mm256_set1_ps(s.moistureDown);
+    const __m256 ft = _mm256_set1_ps(s.fertilityTarget), fup = _mm256_set1_ps(s.fertilityUp);
+    __m256 below = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 mv = _mm256_loadu_ps(m + i);
+        _mm256_storeu_ps(m + i, _mm256_max_ps(_mm256_min_ps(_mm256_add_ps(mv, up), mt), _mm256_sub_ps(mv, down)));
+        __m256 fv = _mm256_loadu_ps(f + i);
+        below = _mm256_or_ps(below, _mm256_cmp_ps(fv, ft, _CMP_LT_OQ));
+        _mm256_storeu_ps(f + i, _mm256_max_ps(fv, _mm256_min_ps(_mm256_add_ps(fv, fup), ft)));
+    }
+    bool changed = _mm256_movemask_ps(below) != 0;
+    return soilScalar(m + i, f + i, n - i, s) || changed;
+}
+
+static bool cpuHasAVX2() { __builtin_cpu_init(); return __builtin_cpu_supports("avx2"); }
+#endif
+
+size_t soilKernelVariants(SoilKernelVariant* out, size_t max) {
+    size_t n = 0;
+    auto add = [&](const char* name, SoilKernelFn fn){ if (n < max) out[n++] = {name, fn}; };
+#ifdef SOIL_HAVE_AVX2
+    if (cpuHasAVX2()) add("avx2", soilAVX2);
+#endif
+#ifdef SOIL_HAVE_SSE2
+    add("sse2", soilSSE2);
+#endif
+    add("scalar", soilScalar);
+    return n;
+}
+
+static const SoilKernelVariant& bestVariant() {
+    static const SoilKernelVariant best = []{ SoilKernelVariant v[3]; soilKernelVariants(v, 3); return v[0]; }();
+    return best;
+}
+
+SoilKernelFn soilKernel() { return bestVariant().fn; }
+const char* soilKernelName() { return bestVariant().name; }
@@ -0,0 +1,32 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+// Per-tick soil relaxation over flat float arrays (moisture toward target, fertility regen up to target).
+// Branch-free min/max form; SSE2/AVX2 variants are picked once at runtime, scalar everywhere else.
+struct SoilStep {
+    float moistureTarget = 0.3f;
+    float moistureDown = 0.f;  // max decay this step when above target
+    float moistureUp = 0.f;    // max recovery this step when below target
+    float fertilityTarget = 0.5f;
+    float fertilityUp = 0.f;   // max regen this step when below target
+};
+
+// single-tile form of the kernel (same min/max expressions, so results match bit for bit);
+// returns true if fertility changed
+inline bool soilStepTile(float& m, float& f, const SoilStep& s) {
+    m = std::max(std::min(m + s.moistureUp, s.moistureTarget), m - s.moistureDown);
+    bool below = f < s.fertilityTarget;
+    f = std::max(f, std::min(f + s.fertilityUp, s.fertilityTarget));
+    return below;
+}
+
+// relaxes n tiles in place; returns true if any fertility value was below target (i.e. changed)
+using SoilKernelFn = bool(*)(float* moisture, float* fertility, size_t n, const SoilStep& s);
+
+SoilKernelFn soilKernel();    // best variant for this CPU
+const char* soilKernelName(); // "avx2", "sse2" or "scalar"
+
+// every variant usable on this CPU, for benchmarks
+struct SoilKernelVariant { const char* name; SoilKernelFn fn; };
+size_t soilKernelVariants(SoilKernelVariant* out, size_t max);
@@ -0,0 +1,120 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::Range SpatialHash::rangeOf(const sf::FloatRect& b) const {
+    return { int(std::floor(b.position.x / cell)), int(std::floor(b.position.y / cell)),
+             int(std::floor((b.position.x + b.size.x) / cell)), int(std::floor((b.position.y + b.size.y) / cell)) };
+}
+
+float SpatialHash::distSq(sf::Vector2f p, const sf::FloatRect& b) {
+    float dx = std::max({b.position.x - p.x, 0.f, p.x - (b.position.x + b.size.x)});
+    float dy = std::max({b.position.y - p.y, 0.f, p.y - (b.position.y + b.size.y)});
+    return dx*dx + dy*dy;
+}
+
+void SpatialHash::link(uint32_t slot) {
+    const Range &r = items[slot].cells;
+    for (int cy = r.y0; cy <= r.y1; ++cy) for (int cx = r.x0; cx <= r.x1; ++cx) cells[key(cx,cy)].push_back(slot);
+}
+
+void SpatialHash::unlink(uint32_t slot) {
+    const Range &r = items[slot].cells;
+    for (int cy = r.y0; cy <= r.y1; ++cy) for (int cx = r.x0; cx <= r.x1; ++cx) {
+        auto it = cells.find(key(cx,cy)); if (it == cells.end()) continue;
+        auto &v = it->second;
+        auto pos = std::find(v.begin(), v.end(), slot);
+        if (pos != v.end()) { *pos = v.back(); v.pop_back(); }
+        if (v.empty()) cells.erase(it);
+    }
+}
+
+void SpatialHash::insert(Entity* e, const sf::FloatRect& bounds, uint32_t mask) {
+    if (slotOf.count(e)) { update(e, bounds); return; }
+    uint32_t slot;
+    if (!freeSlots.empty()) { slot = freeSlots.back(); freeSlots.pop_back(); }
+    else { slot = uint32_t(items.size()); items.emplace_back(); seen.push_back(0); }
+    items[slot] = {e, bounds, mask, rangeOf(bounds)};
+    slotOf[e] = slot;
+    link(slot);
+}
+
+void SpatialHash::update(Entity* e, const sf::FloatRect& bounds) {
+    auto it = slotOf.find(e); if (it == slotOf.end()) return;
+    Item &item = items[it->second];
+    item.b = bounds;
+    Range r = rangeOf(bounds);
+    if (r == item.cells) return; // still in the same cells: nothing to re-bucket
+    unlink(it->second); item.cells = r; link(it->second);
+}
+
+void SpatialHash::remove(Entity* e) {
+    auto it = slotOf.find(e); if (it == slotOf.end()) return;
+    unlink(it->second);
+    items[it->second] = Item{};
+    freeSlots.push_back(it->second);
+    slotOf.erase(it);
+}
+
+template<class F> void SpatialHash::visit(const Range& r, uint32_t mask, F&& f) const {
+    if (++queryId == 0) { std::fill(seen.begin(), seen.end(), 0); queryId = 1; }
+    // huge ranges (a query covering most of the world) are cheaper as one pass over the items
+    if (int64_t(r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1) > int64_t(cells.size())) {
+        for (const auto &kv : slotOf) { const Item &item = items[kv.second]; if (item.mask & mask) f(item); }
+        return;
+    }
+    for (int cy = r.y0; cy <= r.y1; ++cy) for (int cx = r.x0; cx <= r.x1; ++cx) {
+        auto it = cells.find(key(cx,cy)); if (it == cells.end()) continue;
+        for (uint32_t slot : it->second) {
+            if (seen[slot] == queryId) continue;
+            seen[slot] = queryId;
+            const Item &item = items[slot];
+            if (item.mask & mask) f(item);
+        }
+    }
+}
+
+void SpatialHash::queryRect(const sf::FloatRect& q, uint32_t mask, std::vector<Entity*>& out) const {
+    out.clear();
+    visit(rangeOf(q), mask, [&](const Item& item){
+        const sf::FloatRect &b = item.b;
+        if (b.position.x <= q.position.x + q.size.x && q.position.x <= b.position.x + b.size.x &&
+            b.position.y <= q.position.y + q.size.y && q.position.y <= b.position.y + b.size.y) out.push_back(item.e);
+    });
+}
+
+void SpatialHash::queryRadius(sf::Vector2f c, float radius, uint32_t mask, std::vector<Entity*>& out) const {
+    out.clear();
+    sf::FloatRect box({c.x - radius, c.y - radius}, {2.f*radius, 2.f*radius});
+    float r2 = radius * radius;
+    visit(rangeOf(box), mask, [&](const Item& item){ if (distSq(c, item.b) <= r2) out.push_back(item.e); });
+}
+
+Entity* SpatialHash::nearest(sf::Vector2f p, float maxDist, uint32_t mask) const {
+    // grow square rings of cells around p; once the best hit is closer than the ring's inner edge, stop
+    int pcx = int(std::floor(p.x / cell)), pcy = int(std::floor(p.y / cell));
+    int maxRing = int(std::ceil(maxDist / cell)) + 1;
+    Entity* best = nullptr; float bestSq = maxDist * maxDist;
+    auto consider = [&](const Item& item){ float d = distSq(p, item.b); if (d <= bestSq) { bestSq = d; best = item.e; } };
+    if (++queryId == 0) { std::fill(seen.begin(), seen.end(), 0); queryId = 1; }
+    auto scan = [&](int cx, int cy){
+        auto it = cells.find(key(cx,cy)); if (it == cells.end()) return;
+        for (uint32_t slot : it->second) {
+            if (seen[slot] == queryId) continue;
+            seen[slot] = queryId;
+            if (items[slot].mask & mask) consider(items[slot]);
+        }
+    };
+    for (int k = 0; k <= maxRing; ++k) {
+        float inner = float(std::max(k - 1, 0)) * cell; // nothing unscanned is closer than this
+        if (best && bestSq <= inner * inner) break;
+        if (int64_t(2*k + 1) * (2*k + 1) > int64_t(cells.size()) * 4) { // ring outgrew the populated cells: finish linearly
+            for (const auto &kv : slotOf) if (items[kv.second].mask & mask) consider(items[kv.second]);
+            break;
+        }
+        if (k == 0) { scan(pcx, pcy); continue; }
+        for (int i = -k; i <= k; ++i) { scan(pcx + i, pcy - k); scan(pcx + i, pcy + k); }
+        for (int i = -k + 1; i <= k - 1; ++i) { scan(pcx - k, pcy + i); scan(pcx + k, pcy + i); }
+    }
+    return best;
+}
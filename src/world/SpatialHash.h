@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+class Entity;
+
+// Uniform grid hashed on cell coordinates: every entity is bucketed into each cell its bounds overlap,
+// so proximity queries only touch nearby cells. update() re-buckets only when the covered cell range
+// changes, which for most per-tick moves is nothing. Each entry carries a user mask (EntityWorld puts
+// its type bits there) that queries filter on; results come back once per entity, in no fixed order.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 64.f) : cell(cellSize) {}
+    void insert(Entity* e, const sf::FloatRect& bounds, uint32_t mask);
+    void update(Entity* e, const sf::FloatRect& bounds);
+    void remove(Entity* e);
+    void clear() { cells.clear(); items.clear(); slotOf.clear(); freeSlots.clear(); }
+
+    void queryRect(const sf::FloatRect& r, uint32_t mask, std::vector<Entity*>& out) const; // bounds overlap r
+    void queryRadius(sf::Vector2f c, float radius, uint32_t mask, std::vector<Entity*>& out) const; // bounds within radius of c
+    Entity* nearest(sf::Vector2f p, float maxDist, uint32_t mask) const; // closest bounds to p, nullptr when none in range
+    size_t size() const { return slotOf.size(); }
+    float cellSize() const { return cell; }
+
+private:
+    struct Range { int x0, y0, x1, y1; bool operator==(const Range& o) const { return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1; } };
+    struct Item { Entity* e = nullptr; sf::FloatRect b; uint32_t mask = 0; Range cells{0,0,-1,-1}; };
+    static uint64_t key(int cx, int cy) { return (uint64_t(uint32_t(cx)) << 32) | uint32_t(cy); }
+    static float distSq(sf::Vector2f p, const sf::FloatRect& b); // 0 inside
+    Range rangeOf(const sf::FloatRect& b) const;
+    void link(uint32_t slot);
+    void unlink(uint32_t slot);
+    template<class F> void visit(const Range& r, uint32_t mask, F&& f) const; // each live item in r once
+
+    float cell;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells; // cell -> item slots
+    std::vector<Item> items;
+    std::unordered_map<const Entity*, uint32_t> slotOf;
+    std::vector<uint32_t> freeSlots;
+    mutable std::vector<uint32_t> seen; mutable uint32_t queryId = 0; // per-slot dedupe stamps
+};
@@ -1,43 +1,91 @@
 #include "TileMap.h"
+#include "SoilKernel.h"
 #include <algorithm>
 #include <cmath>
 #include <type_traits>
 #include <cstdint>
+#include <limits>
 #include <nlohmann/json.hpp>
 #include "../resources/ResourceManager.h" // for setRailTexture implementation
 #include <iostream> // added for logging
 
 TileMap::TileMap(unsigned width, unsigned height, unsigned tileSize)
-: w(width), h(height), ts(tileSize), tiles(w*h, Empty), soilMoisture(w*h, 0.5f), soilFertility(w*h,0.6f), explored(), railMeta(w*h,0) {}
+: w(width), h(height), ts(tileSize) {
+    resetChunks();
+}
+
+void TileMap::resetChunks() {
+    chunkCols = (w + ChunkTiles - 1) / ChunkTiles;
+    chunkRows = (h + ChunkTiles - 1) / ChunkTiles;
+    chunks.clear(); chunks.resize(size_t(chunkCols) * chunkRows);
+    activeChunks.clear();
+    activeSoil.clear();
+    solidResetEpoch = ++solidEpoch;
+    soilTick = 0; soilEpochs.clear();
+    exploredTiles = 0;
+    railNet.reset(w);
+    changedCells.clear(); cellsReset = true;
+    resetSoilEdits();
+}
+
+TileMap::Chunk& TileMap::writableChunk(unsigned tx, unsigned ty) {
+    unsigned idx = chunkIndex(tx,ty);
+    if (!chunks[idx]) {
+        auto c = std::make_unique<Chunk>();
+        c->tiles.fill(Empty); c->solidRows.fill(0); c->exploredRows.fill(0); c->railMeta.fill(0); c->soilActive.fill(0); c->soilStamp.fill(soilTick);
+        c->moisture.fill(defaultMoisture); c->fertility.fill(defaultFertility);
+        chunks[idx] = std::move(c);
+        activeChunks.push_back(idx);
+        // default soil still relaxing: the new tiles must keep relaxing on their own
+        if (soilMode == SoilMode::Active && !soilConverged(defaultMoisture, defaultFertility)) {
+            unsigned x0 = (idx % chunkCols) * ChunkTiles, y0 = (idx / chunkCols) * ChunkTiles;
+            for (unsigned y = y0; y < std::min(h, y0 + ChunkTiles); ++y)
+                for (unsigned x = x0; x < std::min(w, x0 + ChunkTiles); ++x) { chunks[idx]->soilActive[localIndex(x,y)] = 1; activeSoil.push_back(x + y*w); }
+        }
+    }
+    return *chunks[idx];
+}
 
 void TileMap::generateTestMap() {
-    std::fill(tiles.begin(), tiles.end(), Empty);
+    ++solidEpoch;
+    for (unsigned i : activeChunks) { chunks[i]->tiles.fill(Empty); chunks[i]->solidRows.fill(0); chunks[i]->railMeta.fill(0); chunks[i]->solidStamp = solidEpoch; }
+    markAllMeshesDirty();
+    railNet.reset(w);
+    changedCells.clear(); cellsReset = true;
+    auto put = [&](unsigned x, unsigned y, Tile t){ storeTile(writableChunk(x,y), x, y, t); markMeshDirty(x,y); };
     // border walls
     for (unsigned x = 0; x < w; ++x) {
-        tiles[x + 0 * w] = Solid;
-        tiles[x + (h-1) * w] = Solid;
+        put(x, 0, Solid);
+        put(x, h-1, Solid);
     }
     for (unsigned y = 0; y < h; ++y) {
-        tiles[0 + y * w] = Solid;
-        tiles[(w-1) + y * w] = Solid;
+        put(0, y, Solid);
+        put(w-1, y, Solid);
     }
     // sample interior obstacles
-    for (unsigned x = 10; x < 15; ++x) tiles[x + 8*w] = Solid;
-    for (unsigned y = 12; y < 18; ++y) tiles[20 + y*w] = Solid;
+    for (unsigned x = 10; x < std::min(15u, w); ++x) if (8 < h) put(x, 8, Solid);
+    for (unsigned y = 12; y < std::min(18u, h); ++y) if (20 < w) put(20, y, Solid);
 
     // a small patch of plantable soil tiles near (6,6)
-    for (unsigned y = 5; y <= 7; ++y) {
-        for (unsigned x = 5; x <= 7; ++x) {
-            tiles[x + y*w] = Plantable;
+    for (unsigned y = 5; y <= 7 && y < h; ++y) {
+        for (unsigned x = 5; x <= 7 && x < w; ++x) {
+            put(x, y, Plantable);
         }
     }
 }
 
 void TileMap::setTile(unsigned tx, unsigned ty, Tile t) {
     if (!inBounds(tx,ty)) return;
-    tiles[tx + ty*w] = t;
+    if (t == Empty && !chunkAt(tx,ty)) return; // untouched chunk is already all Empty
+    Chunk &c = writableChunk(tx,ty);
+    uint8_t old = c.tiles[localIndex(tx,ty)];
+    bool wasRail = old == Rail;
+    storeTile(c, tx, ty, t);
+    if (old != t) noteCellChange(tx,ty);
+    c.meshDirty = true;
+    if (t == Rail && !wasRail) railNet.add(tx,ty);
+    else if (t != Rail && wasRail) railNet.remove(tx,ty);
     if (t == Rail) {
-        if (railMeta.size()!=w*h) railMeta.assign(w*h,0);
         updateRailConnections(tx,ty);
         // also update neighbors to refresh their bitfields
         if (ty>0) updateRailConnections(tx,ty-1);
@@ -45,237 +93,322 @@ void TileMap::setTile(unsigned tx, unsigned ty, Tile t) {
         if (tx>0) updateRailConnections(tx-1,ty);
         if (tx+1<w) updateRailConnections(tx+1,ty);
     } else {
-        if (railMeta.size()==w*h) {
-            railMeta[tx + ty*w] = 0;
-            // neighbors might lose a connection
-            if (ty>0) updateRailConnections(tx,ty-1);
-            if (ty+1<h) updateRailConnections(tx,ty+1);
-            if (tx>0) updateRailConnections(tx-1,ty);
-            if (tx+1<w) updateRailConnections(tx+1,ty);
-        }
+        c.railMeta[localIndex(tx,ty)] = 0;
+        // neighbors might lose a connection
+        if (ty>0) updateRailConnections(tx,ty-1);
+        if (ty+1<h) updateRailConnections(tx,ty+1);
+        if (tx>0) updateRailConnections(tx-1,ty);
+        if (tx+1<w) updateRailConnections(tx+1,ty);
     }
 }
 
 void TileMap::updateRailConnections(unsigned tx, unsigned ty) {
     if (!inBounds(tx,ty)) return;
-    if (railMeta.size()!=w*h) railMeta.assign(w*h,0);
-    if (!isTileRail(tx,ty)) { railMeta[tx + ty*w] = 0; return; }
+    Chunk *c = chunkAt(tx,ty);
+    if (!c) return; // untouched chunk: no rails, no bits
+    uint8_t &meta = c->railMeta[localIndex(tx,ty)];
+    if (!isTileRail(tx,ty)) { meta = 0; return; }
     uint8_t bits = 0;
     if (ty>0 && isTileRail(tx,ty-1)) bits |= 1; // N
     if (tx+1<w && isTileRail(tx+1,ty)) bits |= 2; // E
     if (ty+1<h && isTileRail(tx,ty+1)) bits |= 4; // S
     if (tx>0 && isTileRail(tx-1,ty)) bits |= 8; // W
-    railMeta[tx + ty*w] = bits;
+    if (meta != bits) c->meshDirty = true; // neighbor may sit in another chunk
+    meta = bits;
 }
 
-void TileMap::draw(sf::RenderWindow& window, bool showRailOverlay) {
-    sf::RectangleShape r; r.setSize({float(ts), float(ts)});
-    static int railDrawCount = 0;
-    for (unsigned y = 0; y < h; ++y) {
-        for (unsigned x = 0; x < w; ++x) {
-            uint8_t t = tiles[x + y*w];
-            if (t != Rail) {
-                switch (t) {
-                    case Empty: r.setFillColor(sf::Color(120,170,140)); break; // grass
-                    case Solid: r.setFillColor(sf::Color(60,60,60)); break; // rock
-                    case Plantable: {
-                        float fert = soilFertility[x + y*w];
-                        sf::Color base(150,110,60); sf::Color rich(180,140,90);
-                        auto lerp=[&](uint8_t a,uint8_t b){ return uint8_t(a + (b-a)*fert); };
-                        r.setFillColor(sf::Color(lerp(base.r,rich.r), lerp(base.g,rich.g), lerp(base.b,rich.b)));
-                    } break;
-                    default: break;
-                }
-                r.setPosition(sf::Vector2f{float(x*ts), float(y*ts)});
-                window.draw(r);
-            } else {
-                if (railTexture) {
-                    uint8_t bits = railBits(x,y);
-                    if ((railDrawCount++ % 25) == 0) std::cerr << "[RailDraw] textured rail at ("<<x<<","<<y<<") bits="<<(int)bits<<" texSize="<<railTexture->getSize().x<<"x"<<railTexture->getSize().y<<"\n";
-                    sf::Sprite railSprite(*railTexture);
-                    railSprite.setOrigin({railTexture->getSize().x*0.5f, railTexture->getSize().y*0.5f});
-                    float scaleFactor = 0.95f; // nearly fill tile for visibility
-                    float sx = scaleFactor * (float)ts / railTexture->getSize().x;
-                    float sy = scaleFactor * (float)ts / railTexture->getSize().y;
-                    railSprite.setScale({sx, sy});
-                    bool horiz = (bits & 2) || (bits & 8); // east or west connection
-                    bool vert  = (bits & 1) || (bits & 4); // north or south connection
-                    // default texture faces up (north). If horizontal only (or stronger horizontal), rotate 90°.
-                    if (horiz && !vert) railSprite.setRotation(sf::degrees(90.f));
-                    railSprite.setPosition({x*ts + ts*0.5f, y*ts + ts*0.5f});
-                    window.draw(railSprite);
-                } else {
-                    if ((railDrawCount++ % 25) == 0) std::cerr << "[RailDraw] fallback rail at ("<<x<<","<<y<<")\n";
-                    // explicit fallback colored rect
-                    uint8_t bits = railBits(x,y);
-                    int cnt = ((bits&1)!=0)+((bits&2)!=0)+((bits&4)!=0)+((bits&8)!=0);
-                    sf::Color base(100,80,40);
-                    if (cnt==1) base = sf::Color(110,90,50);
-                    else if (cnt==2) base = sf::Color(125,105,60);
-                    else if (cnt==3) base = sf::Color(140,120,70);
-                    else if (cnt==4) base = sf::Color(160,140,80);
-                    r.setFillColor(base);
-                    r.setPosition(sf::Vector2f{float(x*ts), float(y*ts)});
-                    window.draw(r);
-                }
+// append one quad (two triangles) with optional texture coordinates (tl,tr,br,bl)
+static void appendQuad(sf::VertexArray& va, sf::Vector2f pos, sf::Vector2f size, sf::Color color,
+                       const sf::Vector2f* tex = nullptr) {
+    sf::Vector2f tl = pos, tr{pos.x + size.x, pos.y}, br = pos + size, bl{pos.x, pos.y + size.y};
+    sf::Vector2f t[4] = {{0.f,0.f},{0.f,0.f},{0.f,0.f},{0.f,0.f}};
+    if (tex) for (int i=0;i<4;++i) t[i] = tex[i];
+    va.append({tl, color, t[0]}); va.append({tr, color, t[1]}); va.append({br, color, t[2]});
+    va.append({tl, color, t[0]}); va.append({br, color, t[2]}); va.append({bl, color, t[3]});
+}
+
+sf::Color TileMap::groundColor(unsigned x, unsigned y) const {
+    switch (tileAt(x,y)) {
+        case Empty: return sf::Color(120,170,140); // grass
+        case Solid: return sf::Color(60,60,60); // rock
+        case Plantable: {
+            float fert = fertility(x,y);
+            sf::Color base(150,110,60); sf::Color rich(180,140,90);
+            auto lerp=[&](uint8_t a,uint8_t b){ return uint8_t(a + (b-a)*fert); };
+            return sf::Color(lerp(base.r,rich.r), lerp(base.g,rich.g), lerp(base.b,rich.b));
+        }
+        case Rail: {
+            // fallback colored rail (used when no rail texture is set), brighter with more connections
+            uint8_t bits = railBits(x,y);
+            int cnt = ((bits&1)!=0)+((bits&2)!=0)+((bits&4)!=0)+((bits&8)!=0);
+            static const sf::Color byCount[5] = {{100,80,40},{110,90,50},{125,105,60},{140,120,70},{160,140,80}};
+            return byCount[cnt];
+        }
+        default: return sf::Color(120,170,140);
+    }
+}
+
+void TileMap::rebuildMeshChunk(Chunk& c, unsigned cx, unsigned cy) {
+    c.ground.clear(); c.railOverlay.clear(); c.plantableQuads.clear();
+    const float tsf = float(ts);
+    const bool atlas = railCellPx != 0;
+    const float cell = float(railCellPx);
+    // untextured quads point at the atlas white cell so ground and rails share one draw
+    sf::Vector2f white = railAtlasCell(RailAtlasWhiteCell) + sf::Vector2f{cell * 0.5f, cell * 0.5f};
+    sf::Vector2f plain[4] = {white, white, white, white};
+    unsigned x0 = cx * ChunkTiles, y0 = cy * ChunkTiles;
+    unsigned x1 = std::min(w, x0 + ChunkTiles), y1 = std::min(h, y0 + ChunkTiles);
+    for (unsigned y = y0; y < y1; ++y) {
+        for (unsigned x = x0; x < x1; ++x) {
+            uint8_t t = c.tiles[localIndex(x,y)];
+            sf::Vector2f pos{x*tsf, y*tsf};
+            if (t != Rail || !atlas) {
+                if (t == Plantable) c.plantableQuads.push_back((unsigned)c.ground.getVertexCount());
+                appendQuad(c.ground, pos, {tsf, tsf}, groundColor(x,y), plain);
             }
-            if (showRailOverlay && tiles[x + y*w] == Rail) {
-                uint8_t bits = railBits(x,y);
-                sf::Vector2f basePos(float(x*ts), float(y*ts));
-                sf::Vertex lines[8]; int li=0;
-                auto push=[&](sf::Vector2f a, sf::Vector2f b){
-                    if (li+1 < 8) {
-                        lines[li].position = a; lines[li].color = sf::Color::Black; ++li;
-                        lines[li].position = b; lines[li].color = sf::Color::Black; ++li;
-                    }
-                };
-                float cx = basePos.x + ts*0.5f; float cy = basePos.y + ts*0.5f;
-                float len = ts*0.4f;
-                if (bits & 1) push({cx,cy},{cx,cy-len});
-                if (bits & 2) push({cx,cy},{cx+len,cy});
-                if (bits & 4) push({cx,cy},{cx,cy+len});
-                if (bits & 8) push({cx,cy},{cx-len,cy});
-                if (li>0) window.draw(lines, li, sf::PrimitiveType::Lines);
+            if (t != Rail) continue;
+            uint8_t bits = c.railMeta[localIndex(x,y)] & 15;
+            if (atlas) {
+                sf::Vector2f a = railAtlasCell(bits + (meshRailOverlay ? 16u : 0u));
+                sf::Vector2f uv[4] = {a, {a.x + cell, a.y}, {a.x + cell, a.y + cell}, {a.x, a.y + cell}};
+                appendQuad(c.ground, pos, {tsf, tsf}, sf::Color::White, uv);
+                continue;
             }
+            float mx = pos.x + tsf*0.5f; float my = pos.y + tsf*0.5f;
+            float len = tsf*0.4f;
+            auto push=[&](sf::Vector2f b){
+                c.railOverlay.append({{mx,my}, sf::Color::Black});
+                c.railOverlay.append({b, sf::Color::Black});
+            };
+            if (bits & 1) push({mx,my-len});
+            if (bits & 2) push({mx+len,my});
+            if (bits & 4) push({mx,my+len});
+            if (bits & 8) push({mx-len,my});
         }
     }
+    c.meshDirty = false; c.tintDirty = false;
+}
+
+void TileMap::bakeRailAtlas() {
+    railCellPx = 0;
+    if (!railTexture || railTexture->getSize().x == 0 || railTexture->getSize().y == 0) return;
+    const unsigned cellPx = std::max(ts, 16u);
+    sf::RenderTexture rt;
+    if (!rt.resize({RailAtlasCols * cellPx, (RailAtlasWhiteCell / RailAtlasCols + 1) * cellPx})) return;
+    rt.clear(sf::Color::Transparent);
+    const float cell = float(cellPx);
+    sf::Vector2f texSize(railTexture->getSize());
+    auto origin = [&](unsigned i){ return sf::Vector2f{float(i % RailAtlasCols * cellPx), float(i / RailAtlasCols * cellPx)}; };
+    for (unsigned i = 0; i < 32; ++i) {
+        unsigned bits = i & 15;
+        sf::Vector2f o = origin(i), mid = o + sf::Vector2f{cell*0.5f, cell*0.5f};
+        // nearly fill the cell; the texture faces north, horizontal-only rails rotate 90deg
+        bool horiz = (bits & 2) || (bits & 8);
+        bool vert  = (bits & 1) || (bits & 4);
+        float inset = cell * 0.025f;
+        sf::Sprite s(*railTexture);
+        s.setOrigin(texSize * 0.5f); s.setPosition(mid);
+        s.setScale({(cell - 2.f*inset) / texSize.x, (cell - 2.f*inset) / texSize.y});
+        if (horiz && !vert) s.setRotation(sf::degrees(90.f));
+        rt.draw(s);
+        if (i < 16) continue;
+        sf::VertexArray lines(sf::PrimitiveType::Lines);
+        float len = cell*0.4f;
+        auto push=[&](sf::Vector2f d){ lines.append({mid, sf::Color::Black}); lines.append({mid + d, sf::Color::Black}); };
+        if (bits & 1) push({0.f,-len});
+        if (bits & 2) push({len,0.f});
+        if (bits & 4) push({0.f,len});
+        if (bits & 8) push({-len,0.f});
+        rt.draw(lines);
+    }
+    sf::RectangleShape white({cell, cell}); white.setPosition(origin(RailAtlasWhiteCell)); white.setFillColor(sf::Color::White);
+    rt.draw(white);
+    rt.display();
+    railAtlas = rt.getTexture();
+    railCellPx = cellPx;
+}
+
+void TileMap::recolorSoil(Chunk& c) {
+    for (unsigned v : c.plantableQuads) {
+        sf::Vector2f p = c.ground[v].position;
+        sf::Color col = groundColor(unsigned(p.x) / ts, unsigned(p.y) / ts);
+        for (unsigned i = 0; i < 6; ++i) c.ground[v + i].color = col;
+    }
+    c.tintDirty = false;
+}
+
+sf::IntRect TileMap::visibleTileRect(const sf::View& view, int padTiles) const {
+    sf::Vector2f half = view.getSize() * 0.5f; sf::Vector2f center = view.getCenter();
+    int tx0 = int(std::floor((center.x - half.x) / ts)) - padTiles;
+    int ty0 = int(std::floor((center.y - half.y) / ts)) - padTiles;
+    int tx1 = int(std::ceil((center.x + half.x) / ts)) + padTiles;
+    int ty1 = int(std::ceil((center.y + half.y) / ts)) + padTiles;
+    tx0 = std::clamp(tx0, 0, int(w)); tx1 = std::clamp(tx1, tx0, int(w));
+    ty0 = std::clamp(ty0, 0, int(h)); ty1 = std::clamp(ty1, ty0, int(h));
+    return sf::IntRect({tx0, ty0}, {tx1 - tx0, ty1 - ty0});
 }
 
-void TileMap::drawMoistureOverlay(sf::RenderWindow& window) {
-    sf::RectangleShape r; r.setSize({float(ts), float(ts)});
-    for (unsigned y=0;y<h;++y){
-        for(unsigned x=0;x<w;++x){
-            uint8_t t = tiles[x + y*w];
-            if (t==Plantable){
-                float m = soilMoisture[x + y*w];
-                uint8_t alpha = static_cast<uint8_t>(std::clamp(m*255.f, 0.f, 255.f));
-                r.setFillColor(sf::Color(40,100,220, alpha/2));
-                r.setPosition({float(x*ts), float(y*ts)});
-                window.draw(r);
+void TileMap::draw(sf::RenderWindow& window, bool showRailOverlay) {
+    sf::IntRect vis = visibleTileRect(window.getView());
+    if (vis.size.x <= 0 || vis.size.y <= 0) return;
+    unsigned cx0 = unsigned(vis.position.x) / ChunkTiles, cx1 = unsigned(vis.position.x + vis.size.x - 1) / ChunkTiles;
+    unsigned cy0 = unsigned(vis.position.y) / ChunkTiles, cy1 = unsigned(vis.position.y + vis.size.y - 1) / ChunkTiles;
+    const float tsf = float(ts);
+    if (railCellPx && showRailOverlay != meshRailOverlay) { meshRailOverlay = showRailOverlay; markAllMeshesDirty(); } // overlay lives in the atlas cells
+    sf::VertexArray untouched(sf::PrimitiveType::Triangles); // one grass quad per untouched chunk, one draw call
+    for (unsigned cy = cy0; cy <= cy1; ++cy) {
+        for (unsigned cx = cx0; cx <= cx1; ++cx) {
+            Chunk *c = chunks[cx + cy*chunkCols].get();
+            if (!c) {
+                sf::Vector2f pos{cx*ChunkTiles*tsf, cy*ChunkTiles*tsf};
+                sf::Vector2f size{std::min(ChunkTiles, w - cx*ChunkTiles)*tsf, std::min(ChunkTiles, h - cy*ChunkTiles)*tsf};
+                appendQuad(untouched, pos, size, sf::Color(120,170,140));
+                continue;
+            }
+            if (c->meshDirty) rebuildMeshChunk(*c, cx, cy);
+            else if (c->tintDirty) recolorSoil(*c);
+            if (railCellPx) window.draw(c->ground, sf::RenderStates(&railAtlas));
+            else {
+                window.draw(c->ground);
+                if (showRailOverlay && c->railOverlay.getVertexCount() > 0) window.draw(c->railOverlay);
             }
         }
     }
+    if (untouched.getVertexCount() > 0) window.draw(untouched);
 }
 
-void TileMap::drawFertilityOverlay(sf::RenderWindow& window) {
-    sf::RectangleShape r; r.setSize({float(ts), float(ts)});
-    for (unsigned y=0;y<h;++y){
-        for(unsigned x=0;x<w;++x){
-            uint8_t t = tiles[x + y*w];
-            if (t==Plantable){
-                float f = soilFertility[x + y*w];
-                // map fertility to green intensity and alpha
-                uint8_t intensity = static_cast<uint8_t>(std::clamp(80.f + f*175.f, 0.f, 255.f));
-                uint8_t alpha = static_cast<uint8_t>(std::clamp(40.f + f*180.f, 0.f, 255.f));
-                r.setFillColor(sf::Color(30, intensity, 30, alpha/2));
-                r.setPosition({float(x*ts), float(y*ts)});
-                window.draw(r);
-            }
+void TileMap::drawMoistureOverlay(sf::RenderWindow& window) { drawSoilOverlay(window, moistureOverlay, false); }
+
+void TileMap::drawFertilityOverlay(sf::RenderWindow& window) { drawSoilOverlay(window, fertilityOverlay, true); }
+
+// straight-line row pass (no branches, view fixed at compile time), same colors as the old per-tile rectangles
+template <bool FertilityView>
+static void packSoilRow(uint8_t *px, const float *v, const uint8_t *tile, unsigned n) {
+    for (unsigned lx = 0; lx < n; ++lx, px += 4) {
+        uint8_t on = tile[lx] == TileMap::Plantable;
+        if constexpr (FertilityView) {
+            px[0] = 30; px[1] = (uint8_t)std::clamp(80.f + v[lx]*175.f, 0.f, 255.f); px[2] = 30;
+            px[3] = (uint8_t)(((uint8_t)std::clamp(40.f + v[lx]*180.f, 0.f, 255.f) / 2) * on);
+        } else {
+            px[0] = 40; px[1] = 100; px[2] = 220;
+            px[3] = (uint8_t)(((uint8_t)std::clamp(v[lx]*255.f, 0.f, 255.f) / 2) * on);
+        }
+    }
+}
+
+void TileMap::lazySoilRow(const Chunk& c, unsigned li0, unsigned n, bool fertilityView, float *out) const {
+    // neighbouring tiles usually share a stamp, so each distinct stamp costs one epoch lookup
+    float a[ChunkTiles], b[ChunkTiles];
+    uint32_t last = ~0u; SoilSpan s{};
+    for (unsigned lx = 0; lx < n; ++lx) {
+        uint32_t st = c.soilStamp[li0 + lx];
+        if (st != last) { last = st; s = soilSince(st); }
+        a[lx] = fertilityView ? s.fert : s.down; b[lx] = s.up;
+    }
+    // same results as evalMoisture/evalFertility, written as clamps so the row vectorizes
+    if (fertilityView) {
+        const float *f = &c.fertility[li0];
+        for (unsigned lx = 0; lx < n; ++lx) out[lx] = std::max(f[lx], std::min(soilFertilityTarget, f[lx] + a[lx]));
+    } else {
+        const float *m = &c.moisture[li0];
+        for (unsigned lx = 0; lx < n; ++lx) out[lx] = std::clamp(soilMoistureTarget, m[lx] - a[lx], m[lx] + b[lx]);
+    }
+}
+
+void TileMap::fillSoilOverlay(SoilOverlay& o, bool fertilityView) const {
+    o.pixels.assign(size_t(w) * h * 4, 0); // untouched chunks have no plantable tiles: stay transparent
+    float vals[ChunkTiles];
+    auto pack = fertilityView ? &packSoilRow<true> : &packSoilRow<false>;
+    for (unsigned idx : activeChunks) {
+        const Chunk &c = *chunks[idx];
+        unsigned x0 = (idx % chunkCols) * ChunkTiles, y0 = (idx / chunkCols) * ChunkTiles;
+        unsigned cw = std::min(ChunkTiles, w - x0), chh = std::min(ChunkTiles, h - y0);
+        for (unsigned ly = 0; ly < chh; ++ly) {
+            unsigned li0 = ly * ChunkTiles;
+            const float *src = fertilityView ? &c.fertility[li0] : &c.moisture[li0];
+            if (soilMode == SoilMode::Lazy) { lazySoilRow(c, li0, cw, fertilityView, vals); src = vals; } // bring lazily stored values up to now first
+            pack(&o.pixels[(size_t(y0 + ly) * w + x0) * 4], src, &c.tiles[li0], cw);
+        }
+    }
+}
+
+void TileMap::drawSoilOverlay(sf::RenderWindow& window, SoilOverlay& o, bool fertilityView) {
+    if (!w || !h) return;
+    if (o.texture.getSize() != sf::Vector2u(w, h)) { if (!o.texture.resize({w, h})) return; o.valid = false; }
+    if (!o.valid || o.age.getElapsedTime().asSeconds() >= SoilOverlayRefreshSeconds) {
+        fillSoilOverlay(o, fertilityView);
+        o.texture.update(o.pixels.data());
+        o.valid = true; o.age.restart();
+    }
+    sf::Sprite sprite(o.texture);
+    sprite.setScale({float(ts), float(ts)});
+    window.draw(sprite);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+static int lowestBit(uint32_t v) { return __builtin_ctz(v); }
+static int highestBit(uint32_t v) { return 31 - __builtin_clz(v); }
+static int bitCount(uint32_t v) { return __builtin_popcount(v); }
+#else
+static int lowestBit(uint32_t v) { int i = 0; while (!(v & 1u)) { v >>= 1; ++i; } return i; }
+static int highestBit(uint32_t v) { int i = 31; while (!(v & 0x80000000u)) { v <<= 1; --i; } return i; }
+static int bitCount(uint32_t v) { int n = 0; for (; v; v &= v - 1) ++n; return n; }
+#endif
+
+// bits lo..hi (inclusive) of a chunk row
+static uint32_t spanMask(unsigned lo, unsigned hi) {
+    uint32_t upto = hi >= 31 ? ~0u : ((1u << (hi + 1)) - 1u);
+    return upto & ~((1u << lo) - 1u);
+}
+
+static_assert(TileMap::ChunkTiles == 32, "solid rows are packed into uint32 masks");
+
+void TileMap::orExplored(unsigned tx, unsigned ty, uint32_t rowMask) {
+    uint32_t &row = writableChunk(tx,ty).exploredRows[ty % ChunkTiles];
+    uint32_t fresh = rowMask & ~row;
+    if (!fresh) return;
+    row |= fresh; exploredTiles += bitCount(fresh);
+    unsigned base = tx - tx % ChunkTiles;
+    for (; fresh; fresh &= fresh - 1) noteCellChange(base + lowestBit(fresh), ty);
+}
+
+void TileMap::recountExplored() {
+    exploredTiles = 0;
+    for (const auto &c : chunks) if (c) for (uint32_t row : c->exploredRows) exploredTiles += bitCount(row);
+}
+
+void TileMap::revealDisc(int tx, int ty, unsigned radius) {
+    if (radius != discRadius) { // integer half-width of the disc at each row offset
+        discRadius = radius; discHalfWidth.assign(radius + 1, 0);
+        long r2 = long(radius) * long(radius);
+        for (unsigned dy = 0; dy <= radius; ++dy) {
+            long hw = radius; while (hw * hw + long(dy) * long(dy) > r2) --hw;
+            discHalfWidth[dy] = unsigned(hw);
+        }
+    }
+    int r = int(radius);
+    for (int dy = -r; dy <= r; ++dy) {
+        int y = ty + dy; if (y < 0 || y >= int(h)) continue;
+        int hw = int(discHalfWidth[unsigned(std::abs(dy))]);
+        int x0 = std::max(tx - hw, 0), x1 = std::min(tx + hw, int(w) - 1);
+        // one OR per chunk the span crosses (a radius-6 disc touches at most two)
+        for (int x = x0; x <= x1; ) {
+            int chunkEnd = std::min(x1, x - x % int(ChunkTiles) + int(ChunkTiles) - 1);
+            orExplored(unsigned(x), unsigned(y), spanMask(unsigned(x) % ChunkTiles, unsigned(chunkEnd) % ChunkTiles));
+            x = chunkEnd + 1;
         }
     }
 }
 
-// detect members on sf::FloatRect (cover SFML2: left/top/width/height, SFML3: position/size, fallbacks x/y/w/h)
-template<typename R, typename = void>
-struct has_member_left : std::false_type {};
-template<typename R>
-struct has_member_left<R, std::void_t<decltype(std::declval<const R&>().left)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_top : std::false_type {};
-template<typename R>
-struct has_member_top<R, std::void_t<decltype(std::declval<const R&>().top)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_width : std::false_type {};
-template<typename R>
-struct has_member_width<R, std::void_t<decltype(std::declval<const R&>().width)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_height : std::false_type {};
-template<typename R>
-struct has_member_height<R, std::void_t<decltype(std::declval<const R&>().height)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_position : std::false_type {};
-template<typename R>
-struct has_member_position<R, std::void_t<decltype(std::declval<const R&>().position)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_size : std::false_type {};
-template<typename R>
-struct has_member_size<R, std::void_t<decltype(std::declval<const R&>().size)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_x : std::false_type {};
-template<typename R>
-struct has_member_x<R, std::void_t<decltype(std::declval<const R&>().x)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_y : std::false_type {};
-template<typename R>
-struct has_member_y<R, std::void_t<decltype(std::declval<const R&>().y)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_w : std::false_type {};
-template<typename R>
-struct has_member_w<R, std::void_t<decltype(std::declval<const R&>().w)>> : std::true_type {};
-
-template<typename R, typename = void>
-struct has_member_h : std::false_type {};
-template<typename R>
-struct has_member_h<R, std::void_t<decltype(std::declval<const R&>().h)>> : std::true_type {};
-
-// SFINAE-overloads to extract x,y,w,h from sf::FloatRect across SFML versions
-
-// position/size (SFML3)
-template<typename R, typename = std::void_t<decltype(std::declval<const R&>().position), decltype(std::declval<const R&>().size)>>
-static void rect_to_xywh_impl(const R& r, float &x, float &y, float &w_, float &h_) {
-    x = r.position.x;
-    y = r.position.y;
-    w_ = r.size.x;
-    h_ = r.size.y;
-}
-
-// left/top/width/height (SFML2)
-template<typename R, typename = std::void_t<decltype(std::declval<const R&>().left), decltype(std::declval<const R&>().top),
-                                            decltype(std::declval<const R&>().width), decltype(std::declval<const R&>().height)>, 
-         typename = void>
-static void rect_to_xywh_impl(const R& r, float &x, float &y, float &w_, float &h_) {
-    x = r.left;
-    y = r.top;
-    w_ = r.width;
-    h_ = r.height;
-}
-
-// x/y/w/h fallback
-template<typename R, typename = std::void_t<decltype(std::declval<const R&>().x), decltype(std::declval<const R&>().y),
-                                            decltype(std::declval<const R&>().w), decltype(std::declval<const R&>().h)>, 
-         typename = void, typename = void>
-static void rect_to_xywh_impl(const R& r, float &x, float &y, float &w_, float &h_) {
-    x = r.x;
-    y = r.y;
-    w_ = r.w;
-    h_ = r.h;
-}
-
-// generic wrapper: calls the first viable impl
-static void rect_to_xywh(const sf::FloatRect& r, float &x, float &y, float &w_, float &h_) {
-    rect_to_xywh_impl(r, x, y, w_, h_);
-}
-
-static bool rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b) {
-    float ax, ay, aw, ah;
-    float bx, by, bw, bh;
-    rect_to_xywh(a, ax, ay, aw, ah);
-    rect_to_xywh(b, bx, by, bw, bh);
-    return !(ax + aw <= bx || bx + bw <= ax || ay + ah <= by || by + bh <= ay);
+void TileMap::syncSolidRows(Chunk& c) {
+    c.solidRows.fill(0); c.solidStamp = ++solidEpoch;
+    for (unsigned li = 0; li < Chunk::Count; ++li) if (c.tiles[li] == Solid) c.solidRows[li / ChunkTiles] |= 1u << (li % ChunkTiles);
 }
 
 bool TileMap::isTileSolid(unsigned tx, unsigned ty) const {
     if (tx >= w || ty >= h) return true;
-    uint8_t t = tiles[tx + ty*w];
-    return t == Solid; // only Solid blocks movement (Rails and Plantable are passable)
+    // only Solid blocks movement (Rails and Plantable are passable)
+    return (solidRowBits(tx / ChunkTiles, ty) >> (tx % ChunkTiles)) & 1u;
 }
 
 bool TileMap::isWorldPosSolid(const sf::Vector2f& worldPos) const {
@@ -286,70 +419,387 @@ bool TileMap::isWorldPosSolid(const sf::Vector2f& worldPos) const {
     return isTileSolid(tx, ty);
 }
 
+bool TileMap::isSpanSolid(unsigned ty, unsigned tx0, unsigned tx1) const {
+    if (ty >= h || w == 0) return false;
+    tx1 = std::min(tx1, w - 1);
+    if (tx0 > tx1) return false;
+    for (unsigned cx = tx0 / ChunkTiles; cx <= tx1 / ChunkTiles; ++cx) {
+        unsigned lo = cx == tx0 / ChunkTiles ? tx0 % ChunkTiles : 0;
+        unsigned hi = cx == tx1 / ChunkTiles ? tx1 % ChunkTiles : ChunkTiles - 1;
+        if (solidRowBits(cx, ty) & spanMask(lo, hi)) return true;
+    }
+    return false;
+}
+
+bool TileMap::isTileRectSolid(unsigned tx0, unsigned ty0, unsigned tx1, unsigned ty1) const {
+    ty1 = std::min(ty1, h ? h - 1 : 0);
+    for (unsigned ty = ty0; ty <= ty1; ++ty) if (isSpanSolid(ty, tx0, tx1)) return true;
+    return false;
+}
+
+int TileMap::firstSolidInRow(unsigned ty, int tx0, int tx1, bool forward) const {
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, int(w) - 1);
+    if (ty >= h || tx0 > tx1) return -1;
+    int c0 = tx0 / int(ChunkTiles), c1 = tx1 / int(ChunkTiles);
+    for (int i = 0; i <= c1 - c0; ++i) {
+        int cx = forward ? c0 + i : c1 - i;
+        unsigned lo = cx == c0 ? tx0 % ChunkTiles : 0;
+        unsigned hi = cx == c1 ? tx1 % ChunkTiles : ChunkTiles - 1;
+        uint32_t bits = solidRowBits(cx, ty) & spanMask(lo, hi);
+        if (bits) return cx * int(ChunkTiles) + (forward ? lowestBit(bits) : highestBit(bits));
+    }
+    return -1;
+}
+
 bool TileMap::isRectColliding(const sf::FloatRect& rect) const {
-    float rx, ry, rw, rh; rect_to_xywh(rect, rx, ry, rw, rh);
     // treat out-of-bounds as colliding (keeps player inside world)
     float worldW = float(w * ts);
     float worldH = float(h * ts);
-    if (rx < 0.f || ry < 0.f || (rx + rw) > worldW || (ry + rh) > worldH) return true;
-    int minTx = std::max(0, int(std::floor(rx / ts)));
-    int maxTx = std::min(int(w) - 1, int(std::floor((rx + rw - 0.0001f) / ts)));
-    int minTy = std::max(0, int(std::floor(ry / ts)));
-    int maxTy = std::min(int(h) - 1, int(std::floor((ry + rh - 0.0001f) / ts)));
-    for (int ty = minTy; ty <= maxTy; ++ty) {
-        for (int tx = minTx; tx <= maxTx; ++tx) {
-            if (!isTileSolid(tx, ty)) continue;
-            sf::FloatRect tileRect(sf::Vector2f{float(tx * ts), float(ty * ts)}, sf::Vector2f{float(ts), float(ts)});
-            float txr, tyr, tww, thh; rect_to_xywh(tileRect, txr, tyr, tww, thh);
-            if (!(rx + rw <= txr || txr + tww <= rx || ry + rh <= tyr || tyr + thh <= ry)) return true;
+    if (rect.position.x < 0.f || rect.position.y < 0.f || rect.position.x + rect.size.x > worldW || rect.position.y + rect.size.y > worldH) return true;
+    unsigned tx0 = unsigned(rect.position.x / ts), ty0 = unsigned(rect.position.y / ts);
+    unsigned tx1 = unsigned(std::max(0.f, (rect.position.x + rect.size.x - 0.0001f) / ts));
+    unsigned ty1 = unsigned(std::max(0.f, (rect.position.y + rect.size.y - 0.0001f) / ts));
+    return isTileRectSolid(tx0, ty0, tx1, ty1);
+}
+
+float TileMap::sweepAxis(const sf::FloatRect& box, float move, bool horizontal) const {
+    if (move == 0.f) return move;
+    const float tsf = float(ts);
+    float posMin = horizontal ? box.position.x : box.position.y;
+    float posMax = posMin + (horizontal ? box.size.x : box.size.y);
+    // perpendicular tile span the box occupies
+    float perpMin = horizontal ? box.position.y : box.position.x;
+    float perpMax = perpMin + (horizontal ? box.size.y : box.size.x);
+    int p0 = int(std::floor(perpMin / tsf)), p1 = int(std::floor((perpMax - 0.0001f) / tsf));
+    // tile lines crossed by the leading edge: blocks starting at/after posMax (forward) or ending at/before posMin (backward)
+    bool forward = move > 0.f;
+    int a0 = forward ? int(std::ceil(posMax / tsf)) : int(std::floor((posMin + move) / tsf));
+    int a1 = forward ? int(std::ceil((posMax + move) / tsf)) - 1 : int(std::floor(posMin / tsf)) - 1;
+    int hit = -1;
+    if (horizontal) {
+        for (int ty = std::max(p0, 0); ty <= std::min(p1, int(h) - 1); ++ty) {
+            int c = firstSolidInRow(ty, a0, a1, forward);
+            if (c >= 0 && (hit < 0 || (forward ? c < hit : c > hit))) hit = c;
+        }
+    } else if (p0 <= p1 && p1 >= 0) {
+        unsigned x0 = unsigned(std::max(p0, 0)), x1 = unsigned(std::max(p1, 0));
+        a0 = std::max(a0, 0); a1 = std::min(a1, int(h) - 1);
+        for (int i = 0; i <= a1 - a0 && hit < 0; ++i) {
+            int ty = forward ? a0 + i : a1 - i;
+            if (isSpanSolid(ty, x0, x1)) hit = ty;
         }
     }
-    return false;
+    if (hit < 0) return move;
+    return forward ? hit * tsf - posMax : (hit + 1) * tsf - posMin;
+}
+
+TileMap::RayHit TileMap::raycast(const sf::Vector2f& from, const sf::Vector2f& to) const {
+    RayHit r;
+    const float tsf = float(ts);
+    sf::Vector2f d = to - from;
+    int tx = int(std::floor(from.x / tsf)), ty = int(std::floor(from.y / tsf));
+    auto blocked = [&](int x, int y){ return x < 0 || y < 0 || isTileSolid(unsigned(x), unsigned(y)); };
+    if (blocked(tx, ty)) { r.hit = true; r.tile = {tx, ty}; r.point = from; r.t = 0.f; return r; }
+    // Amanatides-Woo: t at which the segment crosses the next vertical / horizontal tile line
+    int stepX = d.x > 0.f ? 1 : -1, stepY = d.y > 0.f ? 1 : -1;
+    const float inf = std::numeric_limits<float>::infinity();
+    float dtX = d.x != 0.f ? tsf / std::fabs(d.x) : inf, dtY = d.y != 0.f ? tsf / std::fabs(d.y) : inf;
+    float tMaxX = d.x != 0.f ? ((stepX > 0 ? (tx + 1) * tsf : tx * tsf) - from.x) / d.x : inf;
+    float tMaxY = d.y != 0.f ? ((stepY > 0 ? (ty + 1) * tsf : ty * tsf) - from.y) / d.y : inf;
+    while (true) {
+        float t;
+        if (tMaxX < tMaxY) { t = tMaxX; tx += stepX; tMaxX += dtX; r.normal = {float(-stepX), 0.f}; }
+        else { t = tMaxY; ty += stepY; tMaxY += dtY; r.normal = {0.f, float(-stepY)}; }
+        if (t > 1.f) break;
+        if (blocked(tx, ty)) { r.hit = true; r.tile = {tx, ty}; r.t = t; r.point = from + d * t; return r; }
+    }
+    r.normal = {}; r.point = to;
+    return r;
+}
+
+TileMap::RayHit TileMap::sweepCircle(const sf::Vector2f& from, const sf::Vector2f& to, float radius) const {
+    RayHit best;
+    best.point = to;
+    const float tsf = float(ts);
+    sf::Vector2f d = to - from;
+    // candidate tiles: bounds of the swept circle, scanned row by row through the solid masks
+    int tx0 = int(std::floor((std::min(from.x, to.x) - radius) / tsf)), tx1 = int(std::floor((std::max(from.x, to.x) + radius) / tsf));
+    int ty0 = int(std::floor((std::min(from.y, to.y) - radius) / tsf)), ty1 = int(std::floor((std::max(from.y, to.y) + radius) / tsf));
+    ty0 = std::max(ty0, 0); ty1 = std::min(ty1, int(h) - 1);
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = firstSolidInRow(ty, tx0, tx1, true); tx >= 0; tx = firstSolidInRow(ty, tx + 1, tx1, true)) {
+            // ray vs tile grown by radius (slab test), then round the corners with ray vs circle
+            float bx0 = tx * tsf, by0 = ty * tsf, bx1 = bx0 + tsf, by1 = by0 + tsf;
+            float tEnter = 0.f, tExit = 1.f; sf::Vector2f n;
+            bool inside = true, miss = false;
+            auto slab = [&](float p, float dp, float lo, float hi, sf::Vector2f axis){
+                if (dp == 0.f) { if (p < lo || p > hi) miss = true; return; }
+                float t0 = (lo - p) / dp, t1 = (hi - p) / dp; sf::Vector2f nn = -axis;
+                if (t0 > t1) { std::swap(t0, t1); nn = axis; }
+                if (t0 > 0.f) inside = false;
+                if (t0 > tEnter) { tEnter = t0; n = nn; }
+                tExit = std::min(tExit, t1);
+            };
+            slab(from.x, d.x, bx0 - radius, bx1 + radius, {1.f, 0.f});
+            slab(from.y, d.y, by0 - radius, by1 + radius, {0.f, 1.f});
+            if (miss || tEnter > tExit || tEnter >= best.t) continue;
+            sf::Vector2f p = inside ? from : from + d * tEnter;
+            // in a corner region the grown box is rounded: intersect with the corner circle instead
+            float cx = std::clamp(p.x, bx0, bx1), cy = std::clamp(p.y, by0, by1);
+            sf::Vector2f off = p - sf::Vector2f{cx, cy};
+            if (inside && off.x*off.x + off.y*off.y <= radius*radius) { tEnter = 0.f; n = {}; } // already touching
+            else if (cx != p.x && cy != p.y) {
+                sf::Vector2f f = from - sf::Vector2f{cx, cy};
+                float a = d.x*d.x + d.y*d.y, b = f.x*d.x + f.y*d.y, c = f.x*f.x + f.y*f.y - radius*radius;
+                float disc = b*b - a*c;
+                if (a == 0.f || disc < 0.f) continue;
+                tEnter = (-b - std::sqrt(disc)) / a;
+                if (tEnter < 0.f || tEnter > 1.f || tEnter >= best.t) continue;
+                p = from + d * tEnter;
+                n = (p - sf::Vector2f{cx, cy}) / radius;
+            }
+            best.hit = true; best.tile = {tx, ty}; best.t = tEnter; best.point = p; best.normal = n;
+        }
+    }
+    return best;
+}
+
+SoilStep TileMap::soilStepFor(float ds) const {
+    SoilStep step;
+    step.moistureTarget = soilMoistureTarget;
+    step.moistureDown = soilMoistureDecay * soilMoistureDecayMult * ds;
+    step.moistureUp = (soilMoistureDecay*0.5f) * ds;
+    step.fertilityTarget = soilFertilityTarget;
+    step.fertilityUp = soilFertilityRegen * ds;
+    return step;
+}
+
+bool TileMap::soilAhead(unsigned tx, unsigned ty, float seconds, float& m, float& f) const {
+    m = moisture(tx,ty); f = fertility(tx,ty);
+    if (seconds > 0.f && inBounds(tx,ty)) soilStepTile(m, f, soilStepFor(seconds)); // relaxation never overshoots: one step covers the span
+    return soilConverged(m, f);
 }
 
 void TileMap::updateSoil(sf::Time dt) {
-    float ds = dt.asSeconds();
-    for (size_t i=0;i<soilMoisture.size();++i) {
-        float &m = soilMoisture[i];
-        if (m > soilMoistureTarget) m = std::max(soilMoistureTarget, m - soilMoistureDecay * soilMoistureDecayMult * ds);
-        else if (m < soilMoistureTarget) m = std::min(soilMoistureTarget, m + (soilMoistureDecay*0.5f) * ds);
+    const SoilStep step = soilStepFor(dt.asSeconds());
+    static const SoilKernelFn kernel = soilKernel();
+    // untouched chunks share one soil value pair
+    kernel(&defaultMoisture, &defaultFertility, 1, step);
+    if (soilMode == SoilMode::Lazy) {
+        // no tile work: extend the soil clock, opening an epoch only when the step size changes
+        const SoilEpoch *e = soilEpochs.empty() ? nullptr : &soilEpochs.back();
+        if (!e || e->stepDown != step.moistureDown || e->stepUp != step.moistureUp || e->stepFert != step.fertilityUp) {
+            SoilEpoch ne{soilTick, 0.0, 0.0, 0.0, step.moistureDown, step.moistureUp, step.fertilityUp};
+            if (e) { double n = soilTick - e->tick; ne.down = e->down + n*e->stepDown; ne.up = e->up + n*e->stepUp; ne.fert = e->fert + n*e->stepFert; }
+            soilEpochs.push_back(ne);
+        }
+        ++soilTick;
+        // fertility drifts without writes; refresh soil tint a couple of times per second
+        if (soilTick % 30 == 0) for (unsigned idx : activeChunks) chunks[idx]->tintDirty = true;
+        if (soilEpochs.size() > 1024 || soilTick > (1u << 30)) materializeSoil();
+        return;
+    }
+    if (soilMode == SoilMode::Sweep) {
+        // chunk arrays are contiguous, so each chunk is one vectorized sweep
+        for (unsigned idx : activeChunks) {
+            Chunk &c = *chunks[idx];
+            if (kernel(c.moisture.data(), c.fertility.data(), Chunk::Count, step)) c.tintDirty = true;
+        }
+        return;
     }
-    float fertStep = soilFertilityRegen * ds;
-    for (float &f : soilFertility) {
-        if (f < soilFertilityTarget) f = std::min(soilFertilityTarget, f + fertStep);
+    // active set: cost follows the tiles the farm touched, converged tiles drop out (swap-remove)
+    for (size_t i = 0; i < activeSoil.size();) {
+        unsigned tx = activeSoil[i] % w, ty = activeSoil[i] / w;
+        Chunk &c = *chunkAt(tx,ty); unsigned li = localIndex(tx,ty);
+        if (soilStepTile(c.moisture[li], c.fertility[li], step)) c.tintDirty = true;
+        if (soilConverged(c.moisture[li], c.fertility[li])) {
+            c.soilActive[li] = 0;
+            activeSoil[i] = activeSoil.back(); activeSoil.pop_back();
+        } else ++i;
+    }
+}
+
+void TileMap::touchSoil(Chunk& c, unsigned tx, unsigned ty) {
+    unsigned li = localIndex(tx,ty);
+    if (soilMode == SoilMode::Lazy) {
+        c.moisture[li] = evalMoisture(c, li); c.fertility[li] = evalFertility(c, li);
+        c.soilStamp[li] = soilTick;
+    } else if (soilMode == SoilMode::Active && !c.soilActive[li]) {
+        c.soilActive[li] = 1; activeSoil.push_back(tx + ty*w);
+    }
+}
+
+TileMap::SoilSpan TileMap::soilSince(uint32_t tick) const {
+    if (soilEpochs.empty() || tick >= soilTick) return {0.f, 0.f, 0.f};
+    // cumulative step totals at a tick: last epoch starting at or before it, extended linearly
+    auto cumAt = [&](uint32_t t, double &d, double &u, double &f){
+        auto it = std::upper_bound(soilEpochs.begin(), soilEpochs.end(), t, [](uint32_t v, const SoilEpoch& e){ return v < e.tick; });
+        if (it == soilEpochs.begin()) { d = u = f = 0.0; return; }
+        const SoilEpoch &e = *(it - 1); double n = t - e.tick;
+        d = e.down + n*e.stepDown; u = e.up + n*e.stepUp; f = e.fert + n*e.stepFert;
+    };
+    double d0,u0,f0,d1,u1,f1;
+    cumAt(tick, d0,u0,f0); cumAt(soilTick, d1,u1,f1);
+    return {float(d1 - d0), float(u1 - u0), float(f1 - f0)};
+}
+
+float TileMap::evalMoisture(const Chunk& c, unsigned li) const {
+    float m = c.moisture[li];
+    if (soilMode != SoilMode::Lazy) return m;
+    SoilSpan s = soilSince(c.soilStamp[li]);
+    // relaxation never overshoots, so the whole span collapses to one clamp toward the target
+    return m > soilMoistureTarget ? std::max(soilMoistureTarget, m - s.down) : std::min(soilMoistureTarget, m + s.up);
+}
+
+float TileMap::evalFertility(const Chunk& c, unsigned li) const {
+    float f = c.fertility[li];
+    if (soilMode != SoilMode::Lazy || f >= soilFertilityTarget) return f;
+    return std::min(soilFertilityTarget, f + soilSince(c.soilStamp[li]).fert);
+}
+
+void TileMap::materializeSoil() {
+    if (soilMode == SoilMode::Lazy) {
+        for (unsigned idx : activeChunks) {
+            Chunk &c = *chunks[idx];
+            for (unsigned li = 0; li < Chunk::Count; ++li) { c.moisture[li] = evalMoisture(c, li); c.fertility[li] = evalFertility(c, li); }
+            c.tintDirty = true;
+        }
+    }
+    for (unsigned idx : activeChunks) chunks[idx]->soilStamp.fill(0);
+    soilTick = 0; soilEpochs.clear();
+}
+
+void TileMap::setSoilTunables(float moistureTarget, float moistureDecayPerSec, float fertilityTarget, float fertilityRegenPerSec) {
+    materializeSoil(); // lazy values are only valid for the targets they were stamped under
+    soilMoistureTarget = moistureTarget; soilMoistureDecay = moistureDecayPerSec; soilFertilityTarget = fertilityTarget; soilFertilityRegen = fertilityRegenPerSec;
+    rescanSoil(); // new targets can move any tile off equilibrium
+    resetSoilEdits();
+}
+
+void TileMap::setSoilMode(SoilMode m) {
+    if (soilMode == m) return;
+    materializeSoil();
+    soilMode = m;
+    rescanSoil();
+}
+
+void TileMap::rescanSoil() {
+    activeSoil.clear();
+    for (unsigned idx : activeChunks) chunks[idx]->soilActive.fill(0);
+    if (soilMode != SoilMode::Active) return;
+    for (unsigned idx : activeChunks) {
+        Chunk &c = *chunks[idx];
+        unsigned x0 = (idx % chunkCols) * ChunkTiles, y0 = (idx / chunkCols) * ChunkTiles;
+        for (unsigned y = y0; y < std::min(h, y0 + ChunkTiles); ++y)
+            for (unsigned x = x0; x < std::min(w, x0 + ChunkTiles); ++x) {
+                unsigned li = localIndex(x,y);
+                if (!soilConverged(c.moisture[li], c.fertility[li])) { c.soilActive[li] = 1; activeSoil.push_back(x + y*w); }
+            }
     }
 }
 
 void TileMap::addWater(unsigned tx, unsigned ty, float amt) {
     if (!inBounds(tx,ty)) return;
-    float &m=soilMoisture[tx+ty*w];
+    Chunk &c = writableChunk(tx,ty);
+    touchSoil(c, tx, ty);
+    float &m=c.moisture[localIndex(tx,ty)];
     m = std::min(1.f, m + amt);
+    noteSoilEdit(tx,ty);
 }
 
 void TileMap::addFertility(unsigned tx, unsigned ty, float amt) {
     if (!inBounds(tx,ty)) return;
-    float &f=soilFertility[tx+ty*w];
+    Chunk &c = writableChunk(tx,ty);
+    touchSoil(c, tx, ty);
+    float &f=c.fertility[localIndex(tx,ty)];
     f = std::max(0.f, std::min(1.f, f + amt));
+    c.tintDirty = true;
+    noteSoilEdit(tx,ty);
 }
 
 nlohmann::json TileMap::toJson() const {
-    nlohmann::json j; j["w"]=w; j["h"]=h; j["ts"]=ts; j["tiles"]=tiles; j["soilMoisture"]=soilMoisture; j["soilFertility"]=soilFertility; j["explored"]=explored; if (railMeta.size()==w*h) j["railMeta"]=railMeta; return j; }
+    // chunked format: only allocated chunks are written, untouched ones restore from the defaults
+    nlohmann::json j; j["w"]=w; j["h"]=h; j["ts"]=ts; j["chunkTiles"]=ChunkTiles;
+    j["defaultMoisture"]=defaultMoisture; j["defaultFertility"]=defaultFertility;
+    j["chunks"]=nlohmann::json::array();
+    for (unsigned idx : activeChunks) {
+        const Chunk &c = *chunks[idx];
+        nlohmann::json cj; cj["cx"]=idx % chunkCols; cj["cy"]=idx / chunkCols;
+        std::array<float,Chunk::Count> m, f; // current values (Lazy stores values as of their stamp)
+        for (unsigned li = 0; li < Chunk::Count; ++li) { m[li] = evalMoisture(c, li); f[li] = evalFertility(c, li); }
+        cj["tiles"]=c.tiles; cj["soilMoisture"]=m; cj["soilFertility"]=f; cj["exploredRows"]=c.exploredRows; cj["railMeta"]=c.railMeta;
+        j["chunks"].push_back(cj);
+    }
+    return j;
+}
+
 void TileMap::fromJson(const nlohmann::json& j) {
-    if (!j.contains("w")||!j.contains("h")||!j.contains("ts")||!j.contains("tiles")) return;
-    w=j["w"].get<unsigned>(); h=j["h"].get<unsigned>(); ts=j["ts"].get<unsigned>(); tiles=j["tiles"].get<std::vector<uint8_t>>();
+    if (!j.contains("w")||!j.contains("h")||!j.contains("ts")) return;
+    if (!j.contains("tiles") && !j.contains("chunks")) return;
+    bool chunked = j.contains("chunks") && j.value("chunkTiles", 0u) == ChunkTiles;
+    if (!chunked && !j.contains("tiles")) { // chunks of another size and no flat fallback: keep the current map
+        std::cerr << "TileMap: save uses " << j.value("chunkTiles", 0u) << "-tile chunks (expected " << ChunkTiles << "), not loaded\n";
+        return;
+    }
+    w=j["w"].get<unsigned>(); h=j["h"].get<unsigned>(); ts=j["ts"].get<unsigned>();
+    resetChunks();
+    if (chunked) {
+        defaultMoisture = j.value("defaultMoisture", FreshMoisture); defaultFertility = j.value("defaultFertility", FreshFertility);
+        for (auto &cj : j["chunks"]) {
+            unsigned cx = cj.value("cx", 0u), cy = cj.value("cy", 0u);
+            if (cx >= chunkCols || cy >= chunkRows) continue;
+            Chunk &c = writableChunk(cx*ChunkTiles, cy*ChunkTiles);
+            auto load = [&](const char* key, auto& arr){
+                if (!cj.contains(key)) return;
+                auto v = cj[key].get<std::vector<typename std::decay_t<decltype(arr)>::value_type>>();
+                if (v.size()==arr.size()) std::copy(v.begin(), v.end(), arr.begin());
+            };
+            load("tiles", c.tiles); load("soilMoisture", c.moisture); load("soilFertility", c.fertility);
+            load("exploredRows", c.exploredRows); load("railMeta", c.railMeta);
+            if (!cj.contains("exploredRows") && cj.contains("explored")) { // byte-per-tile chunk saves
+                auto e = cj["explored"].get<std::vector<uint8_t>>();
+                if (e.size() == Chunk::Count) for (unsigned li = 0; li < Chunk::Count; ++li) if (e[li]) c.exploredRows[li / ChunkTiles] |= 1u << (li % ChunkTiles);
+            }
+            syncSolidRows(c);
+        }
+        rebuildRailNetwork();
+        recountExplored();
+        rescanSoil();
+        return;
+    }
+    // legacy flat arrays (w*h each)
+    auto tiles = j["tiles"].get<std::vector<uint8_t>>();
     if (tiles.size()!=w*h) tiles.assign(w*h, Empty);
-    soilMoisture = (j.contains("soilMoisture")? j["soilMoisture"].get<std::vector<float>>() : std::vector<float>(w*h,0.5f));
-    soilFertility = (j.contains("soilFertility")? j["soilFertility"].get<std::vector<float>>() : std::vector<float>(w*h,0.5f));
+    auto soilMoisture = (j.contains("soilMoisture")? j["soilMoisture"].get<std::vector<float>>() : std::vector<float>(w*h,0.5f));
+    auto soilFertility = (j.contains("soilFertility")? j["soilFertility"].get<std::vector<float>>() : std::vector<float>(w*h,0.5f));
     if (soilMoisture.size()!=w*h) soilMoisture.assign(w*h,0.5f);
     if (soilFertility.size()!=w*h) soilFertility.assign(w*h,0.5f);
-    explored = (j.contains("explored")? j["explored"].get<std::vector<uint8_t>>() : std::vector<uint8_t>(w*h,0));
+    auto explored = (j.contains("explored")? j["explored"].get<std::vector<uint8_t>>() : std::vector<uint8_t>(w*h,0));
     if (explored.size()!=w*h) explored.assign(w*h,0);
-    railMeta = (j.contains("railMeta")? j["railMeta"].get<std::vector<uint8_t>>() : std::vector<uint8_t>(w*h,0));
+    auto railMeta = (j.contains("railMeta")? j["railMeta"].get<std::vector<uint8_t>>() : std::vector<uint8_t>(w*h,0));
     if (railMeta.size()!=w*h) railMeta.assign(w*h,0);
+    for (unsigned y=0;y<h;++y) for (unsigned x=0;x<w;++x) {
+        Chunk &c = writableChunk(x,y); unsigned i = x + y*w, li = localIndex(x,y);
+        storeTile(c, x, y, tiles[i]); c.moisture[li]=soilMoisture[i]; c.fertility[li]=soilFertility[i]; if (explored[i]) c.exploredRows[y % ChunkTiles] |= 1u << (x % ChunkTiles); c.railMeta[li]=railMeta[i];
+    }
     // recompute any missing rail bitfields if legacy save (railMeta missing but rails present)
     if (!j.contains("railMeta")) {
         for (unsigned y=0;y<h;++y) for(unsigned x=0;x<w;++x) if (isTileRail(x,y)) updateRailConnections(x,y);
     }
+    rebuildRailNetwork();
+    recountExplored();
+    rescanSoil();
+}
+
+void TileMap::rebuildRailNetwork() {
+    railNet.reset(w);
+    for (unsigned idx : activeChunks) {
+        unsigned x0 = (idx % chunkCols) * ChunkTiles, y0 = (idx / chunkCols) * ChunkTiles;
+        const Chunk &c = *chunks[idx];
+        for (unsigned y = y0; y < std::min(h, y0 + ChunkTiles); ++y)
+            for (unsigned x = x0; x < std::min(w, x0 + ChunkTiles); ++x)
+                if (c.tiles[localIndex(x,y)] == Rail) railNet.add(x,y);
+    }
 }
 
 std::vector<sf::Vector2i> TileMap::railExitOffsets(unsigned tx, unsigned ty) const {
@@ -363,6 +813,8 @@ std::vector<sf::Vector2i> TileMap::railExitOffsets(unsigned tx, unsigned ty) con
 
 void TileMap::setRailTexture(ResourceManager& res, const std::string& path) {
     railTexture = &res.texture(path);
+    bakeRailAtlas();
+    markAllMeshesDirty();
     if (railTexture) {
         auto sz = railTexture->getSize();
         std::cerr << "Rail texture loaded: " << path << " size=" << sz.x << "x" << sz.y << "\n";
@@ -1,59 +1,113 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <memory>
 #include <SFML/Graphics.hpp>
 #include <nlohmann/json.hpp>
+#include "RailNetwork.h"
+struct SoilStep;
 class ResourceManager; // forward declare for texture access
 
 class TileMap {
 public:
     enum Tile : uint8_t { Empty = 0, Solid = 1, Plantable = 2, Rail = 3 };
+    // Sweep: vectorized pass over every allocated tile each tick (dense farms).
+    // Active: only tiles written by addWater/addFertility/adjustFertility, dropped once back at target.
+    // Lazy: no per-tick tile work; tiles keep (value, soil tick of last write) and reads evaluate the
+    //       piecewise-linear relaxation in closed form (matches Sweep up to float rounding, ~1e-5).
+    enum class SoilMode { Sweep, Active, Lazy };
+    static constexpr unsigned ChunkTiles = 32; // chunk side in tiles (unit of storage, meshing and culling); one uint32 solid mask per row
 
     TileMap(unsigned width = 50, unsigned height = 30, unsigned tileSize = 32u);
     void generateTestMap(); // simple demo layout
     void draw(sf::RenderWindow& window, bool showRailOverlay = true);
     void drawMoistureOverlay(sf::RenderWindow& window); // debug overlay: moisture alpha
     void drawFertilityOverlay(sf::RenderWindow& window); // debug overlay: fertility tint
+    // both overlays are w x h textures (one texel per tile) refilled from the soil at most this often
+    static constexpr float SoilOverlayRefreshSeconds = 0.25f;
+    // culling: tiles covered by view (position = first tile, size = tile count), clamped to the map
+    sf::IntRect visibleTileRect(const sf::View& view, int padTiles = 0) const;
 
     // query
     bool isTileSolid(unsigned tx, unsigned ty) const;
     bool isWorldPosSolid(const sf::Vector2f& worldPos) const;
-    bool isRectColliding(const sf::FloatRect& rect) const;
+    bool isRectColliding(const sf::FloatRect& rect) const; // out of world counts as colliding
+    // packed solidity bitmap (one 32-bit mask per chunk row); out-of-map rows/columns are clipped
+    bool isSpanSolid(unsigned ty, unsigned tx0, unsigned tx1) const; // any Solid in tx0..tx1 (inclusive) of row ty
+    bool isTileRectSolid(unsigned tx0, unsigned ty0, unsigned tx1, unsigned ty1) const; // inclusive tile rect
+    // clamp move along one axis so box stops flush against the first Solid tile ahead (tiles it already overlaps are ignored)
+    float sweepAxis(const sf::FloatRect& box, float move, bool horizontal) const;
+    // segment queries in world pixels; the hit reports the first blocking tile along from -> to
+    struct RayHit {
+        bool hit = false;
+        sf::Vector2i tile{-1,-1}; // blocking tile (may lie outside the map for raycast)
+        sf::Vector2f point;       // raycast: where the segment enters the tile; sweepCircle: circle center at contact
+        sf::Vector2f normal;      // surface normal at the hit (axis-aligned, or radial at tile corners)
+        float t = 1.f;            // fraction of the segment travelled before the hit (1 when clear)
+    };
+    RayHit raycast(const sf::Vector2f& from, const sf::Vector2f& to) const; // grid DDA; leaving the map counts as a hit
+    RayHit sweepCircle(const sf::Vector2f& from, const sf::Vector2f& to, float radius) const; // moving circle vs Solid tiles in the map
+    bool lineOfSight(const sf::Vector2f& a, const sf::Vector2f& b) const { return !raycast(a, b).hit; }
+    uint32_t solidVersion() const { return solidEpoch; } // bumps whenever solidity changes anywhere (pathing caches compare it)
+    uint32_t chunkSolidVersion(unsigned cx, unsigned cy) const { auto *c = chunks[cx + cy*chunkCols].get(); return c ? c->solidStamp : 0; } // solidVersion at the chunk's last flip
+    uint32_t solidResetVersion() const { return solidResetEpoch; } // solidVersion when the chunk grid was last resized/cleared
+    unsigned chunkColumns() const { return chunkCols; }
+    unsigned chunkRowCount() const { return chunkRows; }
 
-    bool isTilePlantable(unsigned tx, unsigned ty) const { return inBounds(tx,ty) && tiles[tx + ty*w] == Plantable; }
-    bool isTileRail(unsigned tx, unsigned ty) const { return inBounds(tx,ty) && tiles[tx + ty*w] == Rail; }
-    Tile getTile(unsigned tx, unsigned ty) const { return inBounds(tx,ty) ? static_cast<Tile>(tiles[tx + ty*w]) : Solid; }
+    bool isTilePlantable(unsigned tx, unsigned ty) const { return inBounds(tx,ty) && tileAt(tx,ty) == Plantable; }
+    bool isTileRail(unsigned tx, unsigned ty) const { return inBounds(tx,ty) && tileAt(tx,ty) == Rail; }
+    Tile getTile(unsigned tx, unsigned ty) const { return inBounds(tx,ty) ? static_cast<Tile>(tileAt(tx,ty)) : Solid; }
 
-    void setTile(unsigned tx, unsigned ty, Tile t); // now updates rail connections
-    uint8_t railBits(unsigned tx, unsigned ty) const { return (inBounds(tx,ty) && railMeta.size()==w*h) ? railMeta[tx + ty*w] : 0; }
+    void setTile(unsigned tx, unsigned ty, Tile t); // now updates rail connections; dirties tile meshes
+    uint8_t railBits(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return 0; auto *c = chunkAt(tx,ty); return c ? c->railMeta[localIndex(tx,ty)] : 0; }
     // bit layout: 1=N,2=E,4=S,8=W
 
-    // exploration (fog-of-war for minimap)
-    void markExplored(unsigned tx, unsigned ty) { if (explored.empty()) explored.assign(w*h,0); if (inBounds(tx,ty)) explored[tx + ty*w] = 1; }
-    bool isExplored(unsigned tx, unsigned ty) const { return inBounds(tx,ty) && !explored.empty() && explored[tx + ty*w] != 0; }
+    // exploration (fog-of-war for minimap): one bit per tile, a 32-bit mask per chunk row
+    void markExplored(unsigned tx, unsigned ty) { if (inBounds(tx,ty)) orExplored(tx, ty, 1u << (tx % ChunkTiles)); }
+    bool isExplored(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return false; auto *c = chunkAt(tx,ty); return c && ((c->exploredRows[ty % ChunkTiles] >> (tx % ChunkTiles)) & 1u); }
+    // reveal every tile with dx*dx + dy*dy <= radius*radius: a cached circle stamp OR'd one row span at a time
+    void revealDisc(int tx, int ty, unsigned radius);
+    size_t exploredCount() const { return exploredTiles; }
+    float exploredPercent() const { return w && h ? 100.f * float(exploredTiles) / (float(w) * float(h)) : 0.f; }
+
+    // change journal for cached views (minimap): appends x + y*w of cells whose tile or explored flag changed
+    // since the last call; returns true when everything must be redrawn instead (resize, load, bulk edits)
+    bool drainCellChanges(std::vector<uint32_t>& out) { bool all = cellsReset; out.swap(changedCells); changedCells.clear(); cellsReset = false; return all; }
 
     unsigned width() const { return w; }
     unsigned height() const { return h; }
     unsigned tileSize() const { return ts; }
     sf::Vector2f worldSize() const { return {float(w*ts), float(h*ts)}; }
+    size_t allocatedChunks() const { return activeChunks.size(); } // chunks touched so far (memory footprint)
 
     // Soil system (basic)
     void updateSoil(sf::Time dt);
-    float moisture(unsigned tx, unsigned ty) const { return inBounds(tx,ty)? soilMoisture[tx + ty*w] : 0.f; }
-    float fertility(unsigned tx, unsigned ty) const { return inBounds(tx,ty)? soilFertility[tx + ty*w] : 0.f; }
+    float moisture(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return 0.f; auto *c = chunkAt(tx,ty); return c ? evalMoisture(*c, localIndex(tx,ty)) : defaultMoisture; }
+    float fertility(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return 0.f; auto *c = chunkAt(tx,ty); return c ? evalFertility(*c, localIndex(tx,ty)) : defaultFertility; }
     void addWater(unsigned tx, unsigned ty, float amt);
     void addFertility(unsigned tx, unsigned ty, float amt);
-    void adjustFertility(unsigned tx, unsigned ty, float delta) { if (inBounds(tx,ty)) { soilFertility[tx+ty*w] = std::max(0.f,std::min(1.f, soilFertility[tx+ty*w] + delta)); } }
-    void setSoilTunables(float moistureTarget, float moistureDecayPerSec, float fertilityTarget, float fertilityRegenPerSec) {
-        soilMoistureTarget = moistureTarget; soilMoistureDecay = moistureDecayPerSec; soilFertilityTarget = fertilityTarget; soilFertilityRegen = fertilityRegenPerSec; }
+    void adjustFertility(unsigned tx, unsigned ty, float delta) { if (inBounds(tx,ty)) { Chunk &c = writableChunk(tx,ty); touchSoil(c,tx,ty); float &f = c.fertility[localIndex(tx,ty)]; f = std::max(0.f,std::min(1.f, f + delta)); c.tintDirty = true; noteSoilEdit(tx,ty); } }
+    // true once the tile's soil stopped relaxing (moisture at target, fertility at or above it)
+    bool soilSettled(unsigned tx, unsigned ty) const { return soilConverged(moisture(tx,ty), fertility(tx,ty)); }
+    // a tile's soil `seconds` of relaxation from now, without stepping the map (crops reading ahead of one long
+    // updateSoil in fastForward); returns soilSettled for those values
+    bool soilAhead(unsigned tx, unsigned ty, float seconds, float& m, float& f) const;
+    // soil edit journal (crop scheduling): x + y*w of tiles written by addWater / addFertility / adjustFertility
+    // since the last call; true when every tile must be treated as changed (load, new soil targets or rates)
+    bool drainSoilEdits(std::vector<uint32_t>& out) { bool all = soilEditsReset; out.swap(soilEdits); soilEdits.clear(); soilEditsReset = false; return all; }
+    void setSoilTunables(float moistureTarget, float moistureDecayPerSec, float fertilityTarget, float fertilityRegenPerSec);
+    void setSoilMode(SoilMode m);
+    SoilMode soilModeSetting() const { return soilMode; }
+    size_t activeSoilTiles() const { return activeSoil.size(); }
 
-    void setMoistureDecayMultiplier(float m) { soilMoistureDecayMult = m; }
+    void setMoistureDecayMultiplier(float m) { if (m != soilMoistureDecayMult) { soilMoistureDecayMult = m; resetSoilEdits(); } }
     float moistureDecayMultiplier() const { return soilMoistureDecayMult; }
 
     nlohmann::json toJson() const; // defined in cpp
     void fromJson(const nlohmann::json& j); // defined in cpp
 
-    float moistureAt(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return 0.f; return soilMoisture[tx + ty*w]; }
-    float fertilityAt(unsigned tx, unsigned ty) const { if (!inBounds(tx,ty)) return 0.f; return soilFertility[tx + ty*w]; }
+    float moistureAt(unsigned tx, unsigned ty) const { return moisture(tx,ty); }
+    float fertilityAt(unsigned tx, unsigned ty) const { return fertility(tx,ty); }
 
     uint8_t railConnections(unsigned tx, unsigned ty) const { return railBits(tx,ty); }
     bool railHasNorth(unsigned tx, unsigned ty) const { return (railBits(tx,ty) & 1)!=0; }
@@ -61,22 +115,115 @@ public:
     bool railHasSouth(unsigned tx, unsigned ty) const { return (railBits(tx,ty) & 4)!=0; }
     bool railHasWest(unsigned tx, unsigned ty) const { return (railBits(tx,ty) & 8)!=0; }
     std::vector<sf::Vector2i> railExitOffsets(unsigned tx, unsigned ty) const;
+    const RailNetwork& rails() const { return railNet; } // rail graph + connected components, kept in sync by setTile
 
     void setRailTexture(ResourceManager& res, const std::string& path); // new
 
 private:
     void updateRailConnections(unsigned tx, unsigned ty); // recompute this rail & neighbor rails
+    void rebuildRailNetwork(); // re-add every rail tile (after load)
     bool inBounds(unsigned tx, unsigned ty) const { return tx < w && ty < h; }
+    // Chunked storage: ChunkTiles x ChunkTiles tiles allocated on first write; untouched chunks read as
+    // all Empty with the shared default soil, so memory tracks the area actually in use.
+    struct Chunk {
+        static constexpr unsigned Count = ChunkTiles * ChunkTiles;
+        std::array<uint8_t, Count> tiles;
+        std::array<uint32_t, ChunkTiles> solidRows; // bit (tx % ChunkTiles) set when the tile is Solid
+        uint32_t solidStamp = 0; // solidEpoch of the last solidity change in this chunk
+        std::array<float, Count> moisture;
+        std::array<float, Count> fertility;
+        std::array<uint32_t, ChunkTiles> exploredRows; // bit (tx % ChunkTiles) set once the tile was seen
+        std::array<uint8_t, Count> railMeta; // connection bits for rails
+        std::array<uint8_t, Count> soilActive; // 1 while the tile sits in activeSoil
+        std::array<uint32_t, Count> soilStamp; // Lazy: soilTick at which moisture/fertility were written
+        // batched rendering: one vertex array per tile texture, rebuilt only when dirtied
+        sf::VertexArray ground{sf::PrimitiveType::Triangles}; // every tile; rails sample railAtlas, the rest its white cell
+        sf::VertexArray railOverlay{sf::PrimitiveType::Lines}; // connection lines per rail (only without an atlas)
+        std::vector<unsigned> plantableQuads; // ground vertex offsets of plantable tiles (for recolorSoil)
+        bool meshDirty = true; // geometry stale (setTile / load / texture change)
+        bool tintDirty = false; // plantable colors stale (fertility changed)
+    };
+    static unsigned localIndex(unsigned tx, unsigned ty) { return (tx % ChunkTiles) + (ty % ChunkTiles) * ChunkTiles; }
+    unsigned chunkIndex(unsigned tx, unsigned ty) const { return tx / ChunkTiles + (ty / ChunkTiles) * chunkCols; }
+    const Chunk* chunkAt(unsigned tx, unsigned ty) const { return chunks[chunkIndex(tx,ty)].get(); }
+    Chunk* chunkAt(unsigned tx, unsigned ty) { return chunks[chunkIndex(tx,ty)].get(); }
+    Chunk& writableChunk(unsigned tx, unsigned ty); // allocates on first write, seeded with the default soil
+    uint8_t tileAt(unsigned tx, unsigned ty) const { auto *c = chunkAt(tx,ty); return c ? c->tiles[localIndex(tx,ty)] : Empty; }
+    void storeTile(Chunk& c, unsigned tx, unsigned ty, uint8_t t) { // tile + solid bit together
+        c.tiles[localIndex(tx,ty)] = t; uint32_t bit = 1u << (tx % ChunkTiles);
+        uint32_t &row = c.solidRows[ty % ChunkTiles]; uint32_t old = row;
+        if (t == Solid) row |= bit; else row &= ~bit;
+        if (row != old) c.solidStamp = ++solidEpoch; }
+    void syncSolidRows(Chunk& c); // rebuild masks from tiles (after load)
+    uint32_t solidRowBits(unsigned cx, unsigned ty) const { auto *c = chunks[cx + (ty / ChunkTiles) * chunkCols].get(); return c ? c->solidRows[ty % ChunkTiles] : 0u; }
+    int firstSolidInRow(unsigned ty, int tx0, int tx1, bool forward) const; // -1 when none
+    void resetChunks(); // drop all chunks and size the chunk grid to w x h
+    // active soil set (SoilMode::Active)
+    bool soilConverged(float m, float f) const { return m == soilMoistureTarget && f >= soilFertilityTarget; }
+    SoilStep soilStepFor(float seconds) const; // relaxation allowed over one updateSoil of that length
+    // call before writing a tile's soil: Active registers it, Lazy brings the stored value up to now
+    void touchSoil(Chunk& c, unsigned tx, unsigned ty);
+    void rescanSoil(); // rebuild activeSoil from every allocated tile off equilibrium
+    // lazy soil (SoilMode::Lazy): cumulative per-tick step amounts, one epoch per change of step size
+    struct SoilEpoch { uint32_t tick; double down, up, fert; float stepDown, stepUp, stepFert; };
+    struct SoilSpan { float down, up, fert; }; // total relaxation allowed between two soil ticks
+    SoilSpan soilSince(uint32_t tick) const;
+    float evalMoisture(const Chunk& c, unsigned li) const;
+    float evalFertility(const Chunk& c, unsigned li) const;
+    void lazySoilRow(const Chunk& c, unsigned li0, unsigned n, bool fertilityView, float *out) const; // Lazy: n tiles of one row brought up to now
+    void materializeSoil(); // Lazy: bake every tile to the current tick and restart the soil clock
+    void orExplored(unsigned tx, unsigned ty, uint32_t rowMask); // set row bits of tx's chunk; counts + journals the new ones
+    void recountExplored();
+    void noteCellChange(unsigned tx, unsigned ty) {
+        if (cellsReset) return;
+        changedCells.push_back(tx + ty*w);
+        if (changedCells.size() > size_t(w) * h / 8 + 1024) { cellsReset = true; changedCells.clear(); } }
+    void noteSoilEdit(unsigned tx, unsigned ty) {
+        if (soilEditsReset) return;
+        soilEdits.push_back(tx + ty*w);
+        if (soilEdits.size() > size_t(w) * h / 8 + 1024) resetSoilEdits(); }
+    void resetSoilEdits() { soilEdits.clear(); soilEditsReset = true; }
+    void markMeshDirty(unsigned tx, unsigned ty) { if (auto *c = chunkAt(tx,ty)) c->meshDirty = true; }
+    void markAllMeshesDirty() { for (unsigned i : activeChunks) chunks[i]->meshDirty = true; }
+    void rebuildMeshChunk(Chunk& chunk, unsigned cx, unsigned cy);
+    void recolorSoil(Chunk& chunk); // refresh plantable tint (no geometry rebuild)
+    sf::Color groundColor(unsigned tx, unsigned ty) const;
+    struct SoilOverlay { std::vector<uint8_t> pixels; sf::Texture texture; sf::Clock age; bool valid = false; };
+    void drawSoilOverlay(sf::RenderWindow& window, SoilOverlay& overlay, bool fertilityView);
+    void fillSoilOverlay(SoilOverlay& overlay, bool fertilityView) const;
     unsigned w, h, ts;
-    std::vector<uint8_t> tiles;
-    std::vector<float> soilMoisture;
-    std::vector<float> soilFertility;
-    std::vector<uint8_t> explored;
-    std::vector<uint8_t> railMeta; // parallel array storing connection bits for rails
+    std::vector<std::unique_ptr<Chunk>> chunks; // chunkCols x chunkRows, null = untouched
+    std::vector<unsigned> activeChunks; // indices of allocated chunks (soil update / save order)
+    uint32_t solidEpoch = 0;
+    uint32_t solidResetEpoch = 0;
+    unsigned chunkCols = 0, chunkRows = 0;
+    static constexpr float FreshMoisture = 0.5f, FreshFertility = 0.6f; // soil of a new map (and of chunked saves without defaults)
+    float defaultMoisture = FreshMoisture; // soil of untouched chunks, evolves with updateSoil like any tile
+    float defaultFertility = FreshFertility;
     float soilMoistureTarget = 0.3f;
     float soilMoistureDecay = 0.02f; // per second toward target when above
     float soilFertilityTarget = 0.5f;
     float soilFertilityRegen = 0.005f; // per second when below target
     sf::Texture* railTexture = nullptr; // texture for rail tiles
+    // rail atlas baked by setRailTexture: cells 0..15 are the N/E/S/W masks, 16..31 the same with the
+    // overlay lines drawn in, cell 32 is plain white (texcoords for untextured ground quads)
+    static constexpr unsigned RailAtlasCols = 8, RailAtlasWhiteCell = 32;
+    void bakeRailAtlas();
+    sf::Vector2f railAtlasCell(unsigned cell) const { return {float(cell % RailAtlasCols * railCellPx), float(cell / RailAtlasCols * railCellPx)}; }
+    sf::Texture railAtlas;
+    unsigned railCellPx = 0; // 0 = no atlas (fallback colored rails + line overlay)
+    bool meshRailOverlay = true; // overlay state baked into the chunk meshes
+    RailNetwork railNet;
+    size_t exploredTiles = 0; // popcount of every exploredRows mask
+    std::vector<unsigned> discHalfWidth; unsigned discRadius = UINT32_MAX; // revealDisc stamp: half-width per row offset
+    std::vector<uint32_t> changedCells; // see drainCellChanges
+    bool cellsReset = true;
+    std::vector<uint32_t> soilEdits; // see drainSoilEdits
+    bool soilEditsReset = true;
+    SoilOverlay moistureOverlay, fertilityOverlay;
     float soilMoistureDecayMult = 1.f; // new multiplier applied in updateSoil
+    SoilMode soilMode = SoilMode::Active;
+    std::vector<unsigned> activeSoil; // tile indices (x + y*w) still relaxing toward the soil targets
+    uint32_t soilTick = 0; // updateSoil calls since the last materializeSoil
+    std::vector<SoilEpoch> soilEpochs;
 };
\ No newline at end of file